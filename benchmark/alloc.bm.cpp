@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#define AC_LOX_COUNT_ALLOCATIONS
+#include "bench_env.hpp"
+namespace {
+/// @brief a class of @p methods methods, each @p statements statements long,
+/// and a loop calling one of them @p calls times on the same instance.
+auto make_program(const unsigned methods,
+                  const unsigned statements,
+                  const unsigned calls) {
+  auto body = "var a = 0;\n"s;
+  for (auto i = 0u; i < statements; ++i)
+    body += "a = a + 1;\n";
+  auto program = "class C {\n"s;
+  for (auto i = 0u; i < methods; ++i)
+    program += fmt::format("m{}() {{\n{}return a;\n}}\n", i, body);
+  program += fmt::format("}}\n"
+                         "var o = C();\n"
+                         "for (var i = 0; i < {}; i = i + 1) o.m0();\n",
+                         calls);
+  return program;
+}
+/// @brief a list of @p count instances with @p fields fields each besides the
+/// link, kept alive until the end.
+auto make_instances_program(const unsigned fields, const unsigned count) {
+  auto program = "class Node {}\n"
+                 "var head = nil;\n"s;
+  program += fmt::format("for (var i = 0; i < {}; i = i + 1) {{\n"
+                         "var node = Node();\n"
+                         "node.next = head;\n",
+                         count);
+  for (auto i = 0u; i < fields; ++i)
+    program += fmt::format("node.f{} = i;\n", i);
+  program += "head = node;\n"
+             "}\n";
+  return program;
+}
+} // namespace
+
+static constexpr auto calls = 1000u;
+/// @brief method calls in a loop: the allocations one call makes must not grow
+/// with the size of the class or of the method, i.e. nothing is deep-copied.
+static void BM_MethodCallAllocations(benchmark::State &state) {
+  const auto methods = static_cast<unsigned>(state.range(0));
+  const auto statements = static_cast<unsigned>(state.range(1));
+  const auto name = fmt::format("alloc{}_{}", methods, statements);
+  auto once = write_program(name + "_1.lox",
+                            make_program(methods, statements, calls));
+  auto twice = write_program(name + "_2.lox",
+                             make_program(methods, statements, 2 * calls));
+  auto per_call = 0.0;
+  for (auto _ : state) {
+    const auto before = allocations.load(std::memory_order_relaxed);
+    auto [_2, str] = get_result(once);
+    const auto between = allocations.load(std::memory_order_relaxed);
+    auto [_3, str2] = get_result(twice);
+    const auto after = allocations.load(std::memory_order_relaxed);
+    benchmark::DoNotOptimize(str);
+    benchmark::DoNotOptimize(str2);
+    // the program is the same but for the loop, so the difference is what the
+    // extra calls allocated.
+    per_call = static_cast<double>(static_cast<std::ptrdiff_t>(
+                   (after - between) - (between - before))) /
+               calls;
+  }
+  state.SetItemsProcessed(state.iterations() * 3 * calls);
+  state.counters["allocs/call"] = per_call;
+  std::filesystem::remove(once);
+  std::filesystem::remove(twice);
+}
+static constexpr auto instances = 1000u;
+/// @brief the memory an instance with a few fields takes.
+static void BM_InstanceMemory(benchmark::State &state) {
+  const auto fields = static_cast<unsigned>(state.range(0));
+  const auto name = fmt::format("instances{}", fields);
+  auto once = write_program(name + "_1.lox",
+                            make_instances_program(fields, instances));
+  auto twice = write_program(name + "_2.lox",
+                             make_instances_program(fields, 2 * instances));
+  auto per_instance = 0.0;
+  for (auto _ : state) {
+    const auto before = allocated_bytes.load(std::memory_order_relaxed);
+    auto [_2, str] = get_result(once);
+    const auto between = allocated_bytes.load(std::memory_order_relaxed);
+    auto [_3, str2] = get_result(twice);
+    const auto after = allocated_bytes.load(std::memory_order_relaxed);
+    benchmark::DoNotOptimize(str);
+    benchmark::DoNotOptimize(str2);
+    per_instance = static_cast<double>(static_cast<std::ptrdiff_t>(
+                       (after - between) - (between - before))) /
+                   instances;
+  }
+  state.SetItemsProcessed(state.iterations() * 3 * instances);
+  state.counters["bytes/instance"] = per_instance;
+  std::filesystem::remove(once);
+  std::filesystem::remove(twice);
+}
+
+BENCHMARK(BM_MethodCallAllocations)
+    ->ArgsProduct({{1, 8, 64}, {1, 16}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InstanceMemory)
+    ->DenseRange(1, 7, 3)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,53 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "test_env.hpp"
+
+#ifdef AC_LOX_COUNT_ALLOCATIONS
+#  include <atomic>
+#  include <cstdlib>
+#  include <new>
+#endif
+
+namespace {
+/// @brief run the program at @p filepath as `interpreter run` would.
+/// @return the exit code and what it printed, its errors after its output.
+auto get_result(auto &&filepath) {
+  ExecutionContext ec;
+  ec.commands.emplace_back(ExecutionContext::interpret);
+  ec.input_files.emplace_back(filepath);
+  auto exec = main(3, nullptr, ec);
+  return exec ? std::make_pair(exec,
+                               ec.output_stream.str() + ec.error_stream.str())
+              : std::make_pair(exec, ec.output_stream.str());
+}
+/// @brief write @p program to @p name under the working directory.
+auto write_program(const std::string &name, const std::string &program) {
+  auto filePath = current_path() / name;
+  auto f = std::fstream(filePath, std::ios::out);
+  f << program;
+  return filePath;
+}
+#ifdef AC_LOX_COUNT_ALLOCATIONS
+/// @brief every allocation the process makes and their bytes, counted by the
+/// replaced global `operator new` below.
+std::atomic<size_t> allocations = 0;
+std::atomic<size_t> allocated_bytes = 0;
+#endif
+} // namespace
+
+#ifdef AC_LOX_COUNT_ALLOCATIONS
+/// @note a benchmark opts in by defining `AC_LOX_COUNT_ALLOCATIONS` before
+/// including this header; the replacement is global to its executable.
+void *operator new(const size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc{};
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+#endif
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include "bench_env.hpp"
+namespace {
+/// @brief the naive recursive fibonacci: calls, returns and an `if` each.
+auto make_fib_program(const unsigned n) {
+  return fmt::format("fun fib(n) {{\n"
+                     "  if (n < 2) return n;\n"
+                     "  return fib(n - 1) + fib(n - 2);\n"
+                     "}}\n"
+                     "print fib({});\n",
+                     n);
+}
+/// @brief a function of @p depth nested blocks, each a few statements, that
+/// returns from the innermost one; called in a loop.
+auto make_nested_program(const unsigned depth) {
+  auto body = "return a;\n"s;
+  for (auto i = 0u; i < depth; ++i)
+    body = fmt::format(
+        "{{\nvar b{0} = a;\na = a + 1;\nif (a < 0) a = 0;\n{1}}}\n", i, body);
+  return fmt::format("fun f(a) {{\n{}}}\n"
+                     "var sum = 0;\n"
+                     "for (var i = 0; i < 10000; i = i + 1) sum = sum + f(i);\n"
+                     "print sum;\n",
+                     body);
+}
+} // namespace
+/// @brief recursion: the cost of a call and of unwinding a `return`.
+static void BM_Fib(benchmark::State &state) {
+  const auto n = static_cast<unsigned>(state.range(0));
+  auto path = write_program(fmt::format("fib{}.lox", n), make_fib_program(n));
+  for (auto _ : state) {
+    auto [_2, str] = get_result(path);
+    benchmark::DoNotOptimize(str);
+  }
+  std::filesystem::remove(path);
+}
+/// @brief the statements a `return` unwinds through, and those run on the way.
+static void BM_NestedReturn(benchmark::State &state) {
+  const auto depth = static_cast<unsigned>(state.range(0));
+  auto path = write_program(fmt::format("nested{}.lox", depth),
+                            make_nested_program(depth));
+  for (auto _ : state) {
+    auto [_2, str] = get_result(path);
+    benchmark::DoNotOptimize(str);
+  }
+  // each level runs three statements and the block itself.
+  state.SetItemsProcessed(state.iterations() * 10000 * (4 * depth + 1));
+  std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_Fib)->DenseRange(15, 21, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NestedReturn)->RangeMultiplier(4)->Range(1, 16)->Unit(
+    benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
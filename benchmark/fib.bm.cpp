@@ -1,15 +1,18 @@
 #include <benchmark/benchmark.h>
 #include <filesystem>
-#include "test_env.hpp"
+#include "bench_env.hpp"
 namespace {
-auto get_result(auto &&filepath) {
-  ExecutionContext ec;
-  ec.commands.emplace_back(ExecutionContext::interpret);
-  ec.input_files.emplace_back(filepath);
-  auto exec = main(3, nullptr, ec);
-  return exec ? std::make_pair(exec,
-                               ec.output_stream.str() + ec.error_stream.str())
-              : std::make_pair(exec, ec.output_stream.str());
+/// @brief a loop whose body is an expression of @p terms terms: mostly the
+/// cost of getting from one node to the next.
+auto make_dispatch_program(const unsigned terms) {
+  auto expr = "x"s;
+  for (auto i = 1u; i < terms; ++i)
+    expr = fmt::format("({} + x * {})", expr, i % 7);
+  return fmt::format("var x = 1;\n"
+                     "var sum = 0;\n"
+                     "for (var i = 0; i < 10000; i = i + 1) sum = {};\n"
+                     "print sum;\n",
+                     expr);
 }
 } // namespace
 static auto fibStr = R"(
@@ -33,6 +36,22 @@ static void BM_Fib(benchmark::State &state) {
   }
 }
 
+/// @brief expression nodes evaluated per second.
+static void BM_Dispatch(benchmark::State &state) {
+  const auto terms = static_cast<unsigned>(state.range(0));
+  auto filePath = write_program(fmt::format("dispatch{}.lox", terms),
+                                make_dispatch_program(terms));
+  for (auto _ : state) {
+    auto [_2, str] = get_result(filePath);
+    benchmark::DoNotOptimize(str);
+  }
+  // a term is a grouping, two binaries, a variable and a literal.
+  state.SetItemsProcessed(state.iterations() * 10000 * 5 * terms);
+  std::filesystem::remove(filePath);
+}
+
 BENCHMARK(BM_Fib)->DenseRange(0, 20);
+BENCHMARK(BM_Dispatch)->RangeMultiplier(4)->Range(4, 64)->Unit(
+    benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#define AC_LOX_COUNT_ALLOCATIONS
+#include "bench_env.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+namespace {
+/// @brief declarations, functions, classes and control flow, repeated under
+/// fresh names until the program is @p bytes long.
+auto make_program(const size_t bytes) {
+  auto program = "class Base {}\n"s;
+  for (auto i = 0u; program.size() < bytes; ++i)
+    program += fmt::format(
+        "var v{0} = {0} * 2 + 1;\n"
+        "fun f{0}(a, b) {{\n"
+        "  if (a < b and !(a == nil)) return a + b * v{0};\n"
+        "  while (a > 0) a = a - 1;\n"
+        "  for (var j = 0; j < 3; j = j + 1) print \"s{0}\";\n"
+        "  return -a;\n"
+        "}}\n"
+        "class C{0} < Base {{\n"
+        "  init(x) {{ this.x = x; }}\n"
+        "  m(y) {{ return this.x + f{0}(y, {0}) + super.m(y); }}\n"
+        "}}\n"
+        "print C{0}(v{0}).m(3);\n",
+        i);
+  return program;
+}
+} // namespace
+
+/// @brief tokenizing a generated program of a few megabytes, loaded once: the
+/// memory the tokens take.
+static void BM_Lex(benchmark::State &state) {
+  const auto megabytes = static_cast<size_t>(state.range(0));
+  const auto program = make_program(megabytes << 20);
+  auto path = write_program(fmt::format("lex{}.lox", megabytes), program);
+  auto tokens = size_t{};
+  auto per_lex = size_t{};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto lexer = accat::lox::lexer{};
+    if (!lexer.load(path).ok()) {
+      state.SkipWithError("failed to load the generated program");
+      break;
+    }
+    state.ResumeTiming();
+    const auto before = allocated_bytes.load(std::memory_order_relaxed);
+    benchmark::DoNotOptimize(lexer.lex());
+    per_lex = allocated_bytes.load(std::memory_order_relaxed) - before;
+    tokens = lexer.get_tokens().size();
+    state.PauseTiming();
+    lexer = accat::lox::lexer{};
+    state.ResumeTiming();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(program.size()));
+  state.counters["tokens"] = static_cast<double>(tokens);
+  state.counters["bytes/token"] =
+      static_cast<double>(per_lex) / static_cast<double>(tokens);
+  std::filesystem::remove(path);
+}
+/// @brief building the AST of a generated program of a few megabytes; the
+/// tokens are made once, outside the loop.
+static void BM_Parse(benchmark::State &state) {
+  const auto megabytes = static_cast<size_t>(state.range(0));
+  const auto program = make_program(megabytes << 20);
+  auto path = write_program(fmt::format("parse{}.lox", megabytes), program);
+  auto lexer = accat::lox::lexer{};
+  if (!lexer.load(path).ok() || !lexer.lex().ok()) {
+    state.SkipWithError("failed to lex the generated program");
+    return;
+  }
+  const auto &tokens = lexer.get_tokens();
+  auto per_parse = size_t{};
+  for (auto _ : state) {
+    const auto before = allocations.load(std::memory_order_relaxed);
+    auto parser = accat::lox::parser{};
+    parser.set_views(lexer);
+    auto res = parser.parse(accat::lox::parser::kStatement);
+    per_parse = allocations.load(std::memory_order_relaxed) - before;
+    benchmark::DoNotOptimize(res);
+    benchmark::DoNotOptimize(parser);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(program.size()));
+  state.counters["tokens"] = static_cast<double>(tokens.size());
+  state.counters["allocs/token"] =
+      static_cast<double>(per_parse) / static_cast<double>(tokens.size());
+  std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_Lex)->RangeMultiplier(4)->Range(1, 4)->Unit(
+    benchmark::kMillisecond);
+BENCHMARK(BM_Parse)->RangeMultiplier(4)->Range(1, 4)->Unit(
+    benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
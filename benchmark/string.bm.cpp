@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include "bench_env.hpp"
+namespace {
+/// @brief appends a @p chunk character literal to a string until it's @p size
+/// long, then prints it once.
+auto make_program(const unsigned size, const unsigned chunk) {
+  return fmt::format("var s = \"\";\n"
+                     "for (var i = 0; i < {}; i = i + 1) s = s + \"{}\";\n"
+                     "print s;\n",
+                     size / chunk,
+                     std::string(chunk, 'x'));
+}
+} // namespace
+static constexpr auto size = 1u << 20;
+/// @brief building a 1 MB string by concatenation in a loop.
+static void BM_StringBuild(benchmark::State &state) {
+  auto chunk = static_cast<unsigned>(state.range(0));
+  auto path = write_program("string"s.append(fmt::to_string(chunk)) + ".lox",
+                            make_program(size, chunk));
+  for (auto _ : state) {
+    auto [_2, str] = get_result(path);
+    benchmark::DoNotOptimize(str);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_StringBuild)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+#include <accat/auxilia/auxilia.hpp>
+#include "Evaluatable.hpp"
+#include "Value.hpp"
+namespace {
+using namespace accat::lox;
+namespace auxilia = accat::auxilia;
+/// @brief the value type before NaN-boxing, kept here for comparison.
+using LegacyValue = auxilia::Variant<auxilia::Monostate,
+                                     evaluation::Boolean,
+                                     evaluation::Nil,
+                                     evaluation::Number,
+                                     evaluation::String,
+                                     evaluation::Function,
+                                     evaluation::Class,
+                                     evaluation::Instance>;
+/// @brief the deep equality the interpreter used on the legacy variant.
+auto equal(const LegacyValue &lhs, const LegacyValue &rhs) -> bool {
+  using Bool = evaluation::Boolean;
+  auto pattern = auxilia::match(
+      [](const evaluation::Nil &, const evaluation::Nil &) -> Bool {
+        return evaluation::True;
+      },
+      []<typename T>(const T &l, const T &r) -> Bool { return {l == r}; },
+      [](const auto &, const auto &) -> Bool { return evaluation::False; });
+  return auxilia::visit(pattern, lhs, rhs).is_true();
+}
+auto equal(const Value &lhs, const Value &rhs) -> bool { return lhs == rhs; }
+/// @brief mostly numbers, as in a typical program, then booleans, nil and
+/// a few strings.
+template <typename V> auto make_values(const size_t count) {
+  auto values = std::vector<V>{};
+  values.reserve(count);
+  for (auto i = 0uz; i < count; ++i) {
+    switch (i % 8) {
+    case 0:
+      values.emplace_back(evaluation::String{"value"sv});
+      break;
+    case 1:
+      values.emplace_back(evaluation::Boolean{i % 3 == 0});
+      break;
+    case 2:
+      values.emplace_back(evaluation::Nil{});
+      break;
+    default:
+      values.emplace_back(evaluation::Number{static_cast<double>(i % 5)});
+      break;
+    }
+  }
+  return values;
+}
+} // namespace
+/// @brief copying values, as reading a variable or passing an argument does.
+template <typename V> static void BM_Copy(benchmark::State &state) {
+  const auto values = make_values<V>(static_cast<size_t>(state.range(0)));
+  auto copies = std::vector<V>(values.size());
+  for (auto _ : state) {
+    for (auto i = 0uz; i < values.size(); ++i)
+      copies[i] = values[i];
+    benchmark::DoNotOptimize(copies.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes/value"] = sizeof(V);
+}
+/// @brief comparing neighbouring values with `==`.
+template <typename V> static void BM_Compare(benchmark::State &state) {
+  const auto values = make_values<V>(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto equals = 0uz;
+    for (auto i = 1uz; i < values.size(); ++i)
+      equals += equal(values[i - 1], values[i]);
+    benchmark::DoNotOptimize(equals);
+  }
+  state.SetItemsProcessed(state.iterations() * (state.range(0) - 1));
+}
+
+BENCHMARK_TEMPLATE(BM_Copy, LegacyValue)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Copy, Value)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Compare, LegacyValue)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Compare, Value)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include "bench_env.hpp"
+namespace {
+/// @brief a function declaring @p locals resolved locals, then reading one of
+/// them @p reads times. Only the number of resolved expressions varies between
+/// runs of the same `reads`.
+auto make_program(const unsigned locals, const unsigned reads) {
+  auto program = "fun f() {\n"s;
+  for (auto i = 0u; i < locals; ++i)
+    program += fmt::format("  var v{} = {};\n  v{} = v{};\n", i, i, i, i);
+  program += fmt::format("  var sum = 0;\n"
+                         "  for (var i = 0; i < {}; i = i + 1) sum = sum + v0;\n"
+                         "  return sum;\n"
+                         "}}\n"
+                         "print f();\n",
+                         reads);
+  return program;
+}
+} // namespace
+static constexpr auto reads = 2000u;
+/// @brief cost of reading a local variable while the number of resolved
+/// expressions in the program grows; the time of the same program without the
+/// loop is subtracted, so only the reads are measured.
+static void BM_VariableRead(benchmark::State &state) {
+  auto locals = static_cast<unsigned>(state.range(0));
+  auto name = "locals"s.append(fmt::to_string(locals));
+  auto withReads =
+      write_program(name + ".lox", make_program(locals, reads));
+  auto withoutReads =
+      write_program(name + ".empty.lox", make_program(locals, 0));
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    auto [_2, str] = get_result(withReads);
+    auto middle = std::chrono::steady_clock::now();
+    auto [_3, str2] = get_result(withoutReads);
+    auto end = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(str);
+    benchmark::DoNotOptimize(str2);
+    auto elapsed = (middle - start) - (end - middle);
+    state.SetIterationTime(
+        std::max(std::chrono::duration<double>(elapsed).count(), 0.0));
+  }
+  state.SetItemsProcessed(state.iterations() * reads);
+  std::filesystem::remove(withReads);
+  std::filesystem::remove(withoutReads);
+}
+
+BENCHMARK(BM_VariableRead)->RangeMultiplier(4)->Range(16, 1024)->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -7,7 +7,10 @@
 
 namespace accat::lox::expression {
 /// @implements ExprVisitor
-class AC_LOX_API ASTPrinter : public ExprVisitor, public auxilia::Viewable {
+class AC_LOX_API ASTPrinter final : public ExprVisitor,
+                                  public auxilia::Viewable {
+  friend ExprVisitor;
+
 public:
   using ostream_t = std::ostream;
   using ostringstream_t = std::ostringstream;
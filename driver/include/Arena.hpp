@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+namespace accat::lox {
+/// @brief a bump allocator owning the nodes of a program: they are laid out
+/// one after another in a few large blocks and all freed with the arena, so a
+/// node costs neither an allocation of its own nor a reference count.
+/// @note nodes refer to each other by plain pointers, valid as long as the
+/// arena is, unless @ref rewind frees them first: nothing may still point into
+/// a rewound region, and the interpreter's @ref ResolvedEnv journal of the
+/// nodes resolved there has to be rolled back (`interpreter::retire`) before.
+class AC_LOX_API Arena {
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+public:
+  /// @brief how far the arena had grown, to @ref rewind to.
+  struct mark_t {
+    size_t blocks = 0;
+    std::byte *cursor = nullptr;
+    std::byte *end = nullptr;
+    size_t used = 0;
+    size_t destructors = 0;
+  };
+
+public:
+  Arena() = default;
+  Arena(const Arena &) = delete;
+  auto operator=(const Arena &) -> Arena & = delete;
+  ~Arena() noexcept;
+
+public:
+  template <typename T, typename... Args> auto make(Args &&...args) -> T * {
+    auto object = ::new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      destructors.emplace_back(object,
+                               [](void *ptr) { static_cast<T *>(ptr)->~T(); });
+    return object;
+  }
+  /// @return the bytes handed out so far.
+  auto size() const noexcept -> size_t { return used; }
+  auto mark() const noexcept -> mark_t {
+    return {blocks.size(), cursor, end, used, destructors.size()};
+  }
+  /// @brief destroy the nodes made since @p mark and hand their memory out
+  /// again; nothing may refer to them any more.
+  void rewind(const mark_t &mark) noexcept;
+
+private:
+  auto allocate(size_t, size_t) -> void *;
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  std::byte *cursor = nullptr;
+  std::byte *end = nullptr;
+  size_t used = 0;
+  /// @brief what the nodes need run when the arena goes, in creation order.
+  std::vector<std::pair<void *, void (*)(void *)>> destructors;
+};
+} // namespace accat::lox
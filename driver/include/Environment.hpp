@@ -9,6 +9,7 @@
 #include <string_view>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include <accat/auxilia/auxilia.hpp>
 
@@ -24,6 +25,7 @@ class AC_LOX_API Environment
       public std::enable_shared_from_this<Environment> {
 public:
   using string_view_type = evaluation::ScopeAssoc::string_view_type;
+  using symbol_type = symbol_id_t;
   using scope_env_t = evaluation::ScopeAssoc;
   using self_type = Environment;
 
@@ -45,32 +47,39 @@ public:
   static bool isGlobalScopeInited;
 
 public:
-  auto find(string_view_type, bool = false) const
+  auto find(symbol_type, bool = false) const
       -> std::optional<self_type::scope_env_t::associations_t::const_iterator>;
-  auto find(string_view_type, bool = false)
+  auto find(symbol_type, bool = false)
       -> std::optional<self_type::scope_env_t::associations_t::iterator>;
-  auto find_symbol(string_view_type, bool = false) const
+  auto find_symbol(symbol_type, bool = false) const
       -> std::optional<self_type::scope_env_t::associations_t::const_iterator>;
-  auto find_symbol(string_view_type, bool = false)
+  auto find_symbol(symbol_type, bool = false)
       -> std::optional<self_type::scope_env_t::associations_t::iterator>;
-  auto add(string_view_type,
+  auto add(symbol_type,
            const IVisitor::variant_type &,
            uint_least32_t = std::numeric_limits<uint_least32_t>::quiet_NaN())
       -> auxilia::Status;
-  auto reassign(string_view_type,
+  auto reassign(symbol_type,
                 const IVisitor::variant_type &,
                 uint_least32_t,
                 bool = false) -> auxilia::Status;
-  auto get(string_view_type, bool = false) const -> IVisitor::variant_type *;
+  auto get(symbol_type, bool = false) const -> IVisitor::variant_type *;
   auto ancestor(size_t) const -> std::shared_ptr<self_type>;
-  auto get_at_depth(size_t, string_view_type) const -> IVisitor::variant_type *;
-  auto reassign_at_depth(size_t,
-                         string_view_type,
-                         const IVisitor::variant_type &,
-                         uint_least32_t) -> auxilia::Status;
+  /// @brief define a global at the slot the Resolver assigned to it.
+  /// @note the name is only kept for debugging and by-name lookups.
+  auto define_at(size_t, symbol_type, const IVisitor::variant_type &) -> void;
+  /// @return the slot of this environment, or nullptr if it's not defined yet.
+  auto find_at(size_t) const -> IVisitor::variant_type *;
 
 private:
+  auto ancestor_raw(size_t) const -> self_type *;
+
+private:
+  /// natives and unresolved names, looked up by name.
   scope_env_t current;
+  /// resolved globals, indexed by slot.
+  std::vector<IVisitor::variant_type> slots;
+  std::vector<symbol_type> slot_names;
   std::shared_ptr<self_type> parent;
   static inline std::shared_ptr<self_type> global_env;
   static auto initGlobalEnv() -> std::shared_ptr<self_type>;
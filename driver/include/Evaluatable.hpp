@@ -1,12 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <compare>
+#include <concepts>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <random>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
@@ -17,33 +20,28 @@
 
 #include "details/lox_fwd.hpp"
 #include "details/IVisitor.hpp"
+#include "Token.hpp"
+#include "Value.hpp"
 
 namespace accat::lox::evaluation {
 
 /// @brief A class that represents an evaluatable object
 /// @interface Evaluatable
 /// @implements auxilia::Printable
+/// @note values don't know where they were made: an error message takes its
+/// line from the token of the AST node being evaluated.
 class Evaluatable : public auxilia::Printable {
-protected:
-  static constexpr auto nan =
-      &std::numeric_limits<uint_least32_t>::signaling_NaN;
-
 public:
   using eval_result_t = IVisitor::eval_result_t;
 
 public:
   constexpr Evaluatable() = default;
-  explicit constexpr Evaluatable(const uint_least32_t line) : line(line) {}
   virtual ~Evaluatable() = default;
   auto operator=(const Evaluatable &) -> Evaluatable & = default;
-  uint_least32_t get_line() const { return line; }
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type = 0;
-
-private:
-  uint_least32_t line = nan();
 };
 /// @brief A class that represents a callable object
 class Callable {
@@ -51,13 +49,17 @@ protected:
   virtual ~Callable() = default;
 
 public:
-  using args_t = std::vector<IVisitor::variant_type>;
+  /// @brief the arguments of a call, evaluated in place on the interpreter's
+  /// stack where the callee's frame will start; see
+  /// @ref interpreter::push_args.
+  using args_t = std::span<IVisitor::variant_type>;
+  using upvalues_t = IVisitor::upvalues_t;
   using env_t = Environment;
   using env_ptr_t = std::shared_ptr<env_t>;
 
 public:
   virtual auto arity() const -> unsigned = 0;
-  virtual auto call(interpreter &, args_t &&) -> Evaluatable::eval_result_t = 0;
+  virtual auto call(interpreter &, args_t) -> Evaluatable::eval_result_t = 0;
 };
 
 /// @brief A class that represents a value
@@ -66,7 +68,6 @@ public:
 class Value : public Evaluatable {
 public:
   constexpr Value() = default;
-  constexpr explicit Value(const uint_least32_t line) : Evaluatable(line) {}
   virtual ~Value() override = default;
   explicit operator Boolean() const noexcept;
   Boolean operator!() const noexcept;
@@ -75,16 +76,12 @@ public:
 class AC_LOX_API Boolean : public Value, public auxilia::Viewable {
 public:
   constexpr Boolean() = default;
-  constexpr Boolean(bool value, const uint_least32_t line = nan())
-      : Value(line), value(value) {}
-  constexpr Boolean(long double, const uint_least32_t line = nan())
-      : Value(line), value(true) {}
+  constexpr Boolean(bool value) : value(value) {}
+  constexpr Boolean(long double) : value(true) {}
   Boolean(const Boolean &);
   Boolean &operator=(const Boolean &);
   Boolean(Boolean &&) noexcept;
   Boolean &operator=(Boolean &&) noexcept;
-  static auto make_true(uint_least32_t) -> Boolean;
-  static auto make_false(uint_least32_t) -> Boolean;
   auto is_true() const noexcept -> bool;
   virtual ~Boolean() = default;
 
@@ -102,12 +99,11 @@ public:
 
 private:
   bool value = false;
-} static inline AC_CONSTEXPR20 True{true, 0}, False{false, 0};
+} static inline AC_CONSTEXPR20 True{true}, False{false};
 
 class AC_LOX_API Nil : public Value, public auxilia::Viewable {
 public:
   constexpr Nil() = default;
-  explicit Nil(const uint_least32_t line) : Value(line) {}
   Nil(const Nil &) = default;
   Nil(Nil &&) noexcept {}
   Nil &operator=(const Nil &);
@@ -119,16 +115,34 @@ public:
   auto to_string_view(const auxilia::FormatPolicy &) const -> string_view_type;
 } static inline AC_CONSTEXPR20 NilValue{};
 
-class String : public Evaluatable, public auxilia::Viewable {
+/// @brief an immutable string; copies share its characters.
+/// @note short strings are stored inline. Longer ones are a rope:
+/// concatenation is lazy, the result referring to both operands until it's
+/// flattened into one buffer the first time it's read (printing, comparison,
+/// hashing), so building a string piece by piece is linear.
+/// @note a string made from a literal is interned: it carries the symbol id
+/// of its contents, and two interned strings compare by id.
+class String : public Evaluatable, public Object, public auxilia::Viewable {
+  struct Rope;
+  using rope_ptr_t = std::shared_ptr<const Rope>;
+
+public:
+  /// @brief strings up to this size are concatenated eagerly.
+  static constexpr auto flat_size = 128uz;
+  /// @brief strings up to this size are stored inline.
+  static constexpr auto inline_size = 22uz;
+
 public:
-  constexpr String() = default;
-  explicit String(const string_type &, uint_least32_t line = nan());
-  explicit String(string_view_type, uint_least32_t line = nan());
-  explicit String(string_type &&, uint_least32_t line = nan()) noexcept;
-  String(const String &);
-  String(String &&) noexcept;
-  String &operator=(const String &);
-  String &operator=(String &&) noexcept;
+  String() = default;
+  explicit String(const string_type &);
+  explicit String(string_view_type);
+  explicit String(string_type &&);
+  /// @brief an interned string; @p symbol is the id of its contents.
+  String(string_view_type, symbol_id_t);
+  String(const String &) = default;
+  String(String &&) noexcept = default;
+  String &operator=(const String &) = default;
+  String &operator=(String &&) noexcept = default;
   virtual ~String() override = default;
 
 public:
@@ -136,23 +150,49 @@ public:
   Boolean operator==(const String &) const;
   Boolean operator!=(const String &) const;
   explicit operator Boolean() const;
+  auto size() const noexcept -> size_t;
+  /// @note computed on first use, then cached.
+  auto hash() const -> size_t;
 
 public:
-  auto to_string(const auxilia::FormatPolicy &) const -> string_type override {
-    return value;
-  }
-  auto to_string_view(const auxilia::FormatPolicy &) const -> string_view_type {
-    return value;
-  }
+  auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
+  auto to_string_view(const auxilia::FormatPolicy &) const -> string_view_type;
+
+private:
+  explicit String(rope_ptr_t);
+  /// @brief the characters, flattening the rope if needed.
+  auto view() const -> string_view_type;
+  /// @return the rope, or a new one holding the inline characters.
+  auto as_rope() const -> rope_ptr_t;
 
 private:
-  string_type value;
+  /// @note null if the characters are inline.
+  rope_ptr_t rope;
+  /// @note 0 until computed.
+  mutable size_t cached_hash = 0;
+  symbol_id_t symbol = SymbolTable::kInvalid;
+  std::uint8_t inline_length = 0;
+  std::array<char, inline_size> inline_chars{};
 };
 
+/// @brief an IEEE double, or an integer while the value is integral and
+/// within +-2^53, where the double would be exact; arithmetic on two integers
+/// stays integral unless the result leaves that range, has a fraction or is
+/// -0, in which case it's promoted to the double it equals.
 class Number : public Value {
+public:
+  /// @brief the largest magnitude kept as an integer.
+  static constexpr std::int64_t max_integer = std::int64_t{1} << 53;
+
 public:
   constexpr Number() = default;
-  Number(long double, uint_least32_t line = nan());
+  Number(double);
+  /// @pre the value is within +-max_integer.
+  template <std::integral T>
+  Number(const T integer)
+      : integer(static_cast<std::int64_t>(integer)), integral(true) {}
+  /// @return an integer if @p value is one, so literals take the fast path.
+  static auto from_double(double) -> Number;
   Number(const Number &);
   Number(Number &&) noexcept;
   Number &operator=(const Number &);
@@ -174,19 +214,32 @@ public:
   Number &operator-=(const Number &);
   Number &operator*=(const Number &);
   Number &operator/=(const Number &);
+  auto get_value() const noexcept -> double {
+    return integral ? static_cast<double>(integer) : value;
+  }
+  auto is_integral() const noexcept -> bool { return integral; }
+  /// @pre `is_integral()`
+  auto get_integer() const noexcept -> std::int64_t { return integer; }
 
 private:
-  long double value = std::numeric_limits<long double>::quiet_NaN();
+  /// @note a double, not a long double: a @ref lox::Value holds it in 64 bits.
+  double value = std::numeric_limits<double>::quiet_NaN();
+  std::int64_t integer = 0;
+  bool integral = false;
 
 public:
   auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
 };
-class Function : public Evaluatable, public Callable {
+class Function : public Evaluatable, public Object, public Callable {
   struct RealFunction {
-    using stmt_ptr_t = std::shared_ptr<statement::Stmt>;
+    using stmt_ptr_t = statement::Stmt *;
     string_type name;
-    std::vector<string_type> parameters;
-    std::vector<stmt_ptr_t> body;
+    std::vector<symbol_id_t> parameters;
+    /// @brief the statements of the declaration, which the program's
+    /// @ref Arena keeps.
+    std::span<const stmt_ptr_t> body;
+    size_t frame_size;
+    std::vector<size_t> captured_parameters;
   };
 
 public:
@@ -197,38 +250,57 @@ public:
   using function_t = auxilia::
       Variant<auxilia::Monostate, native_function_t, custom_function_t>;
 
+  /// @brief what a function declaration evaluates to; never changes once
+  /// made, so copies of a function and the methods bound from it share it.
+  struct Closure {
+    // dont support static variables in this function
+    unsigned arity = std::numeric_limits<unsigned>::quiet_NaN();
+    function_t function;
+    /// @brief the outer variables the function uses, in the order the
+    /// Resolver numbered them; the frames they were declared in are not kept
+    /// alive.
+    upvalues_t upvalues;
+    bool is_initializer = false;
+  };
+  using closure_ptr_t = std::shared_ptr<const Closure>;
+
 public:
   Function() = default;
   Function(const Function &) = default;
   Function &operator=(const Function &) = default;
-  Function(Function &&) noexcept;
-  Function &operator=(Function &&) noexcept;
+  Function(Function &&) noexcept = default;
+  Function &operator=(Function &&) noexcept = default;
   virtual ~Function() = default;
 
 private:
-  Function(unsigned, native_function_t &&, const env_ptr_t &, bool = false);
-  Function(unsigned, custom_function_t &&, const env_ptr_t &, bool = false);
-  Function(unsigned, const function_t &, const env_ptr_t &, bool = false);
+  explicit Function(closure_ptr_t);
 
 public:
   static auto
-  create_custom(unsigned, custom_function_t &&, const env_ptr_t &, bool = false)
-      -> Function;
-  static auto
-  create_native(unsigned, native_function_t &&, const env_ptr_t &, bool = false)
+  create_custom(unsigned, custom_function_t &&, upvalues_t &&, bool = false)
       -> Function;
+  static auto create_native(unsigned, native_function_t &&) -> Function;
+  /// @pre @p instance is held by a @ref lox::Value.
   auto bind(const Instance &) const -> Function;
 
 public:
-  virtual inline auto arity() const -> unsigned override { return my_arity; }
-  virtual auto call(interpreter &, args_t &&) -> eval_result_t override;
+  virtual inline auto arity() const -> unsigned override {
+    return closure->arity;
+  }
+  virtual auto call(interpreter &, args_t) -> eval_result_t override;
+  /// @brief call the function as a method of @p self, which takes the first
+  /// slot of its frame, without binding it first.
+  /// @pre @p self holds an instance, or is empty if the function is not a
+  /// method.
+  auto call_method(interpreter &,
+                   const IVisitor::variant_type &self,
+                   args_t) const -> eval_result_t;
 
 private:
-  // dont support static variables in this function
-  unsigned my_arity = std::numeric_limits<unsigned>::quiet_NaN();
-  function_t my_function;
-  env_ptr_t my_env;
-  bool is_initializer = false;
+  closure_ptr_t closure;
+  /// @brief the instance a method is bound to, empty if not bound; it occupies
+  /// the first slot of the method's frame.
+  IVisitor::variant_type receiver;
 
 private:
   static constexpr auto native_signature = "<native fn>"sv;
@@ -237,112 +309,168 @@ public:
   auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
 
 private:
-  friend inline auto operator==(const Function &lhs, const Function &rhs)
-      -> bool {
-    return lhs.my_arity == rhs.my_arity &&
-           lhs.my_function.index() == rhs.my_function.index() &&
-           std::addressof(*lhs.my_env) == std::addressof(*rhs.my_env);
-  }
+  /// @note the same declaration evaluated once, bound to the same instance.
+  friend auto operator==(const Function &, const Function &) -> bool;
   friend inline auto operator!=(const Function &lhs, const Function &rhs)
       -> bool {
     return !(lhs == rhs);
   }
 };
 
-class Class : public Evaluatable, public Callable {
+/// @brief the layout of an instance's fields(a hidden class): the slot each
+/// field occupies. Instances given the same fields in the same order share a
+/// shape; adding a field moves an instance along a transition to the shape
+/// with that field appended.
+/// @note the shapes of a class form a tree the class owns from its root; an
+/// instance keeps its class, hence its shape, alive.
+class Shape {
 public:
-  using methods_t = std::unordered_map<string_type, Function>;
+  static constexpr auto npos = std::numeric_limits<size_t>::max();
+
+public:
+  Shape() = default;
+  Shape(const Shape &) = delete;
+  Shape(Shape &&) noexcept = default;
+
+public:
+  /// @return the slot of the field, or @ref npos if it has none.
+  auto find(symbol_id_t) const noexcept -> size_t;
+  /// @return the shape with the field appended, made the first time it's
+  /// asked for.
+  auto with(symbol_id_t) const -> const Shape *;
+  auto size() const noexcept -> size_t { return symbols.size(); }
+
+private:
+  /// @brief the fields in slot order.
+  std::vector<symbol_id_t> symbols;
+  mutable std::unordered_map<symbol_id_t, std::unique_ptr<Shape>> transitions;
+};
+
+class Class : public Evaluatable, public Object, public Callable {
+public:
+  using methods_t = std::unordered_map<symbol_id_t, Function>;
   string_type name;
+  symbol_id_t symbol;
+  /// @brief every method an instance responds to: the class's own and, where
+  /// it doesn't override them, those it inherits.
+  /// @note flattened once when the class is defined, so finding a method never
+  /// walks the superclasses.
   methods_t methods;
 
 private:
-  string_type superclass_name;
-  env_ptr_t superclass_env;
+  /// @brief the class value itself, not a copy: classes are shared like any
+  /// other object.
+  IVisitor::variant_type superclass;
+  /// @brief the class @ref superclass holds, or nullptr.
+  const Class *base = nullptr;
+  /// @brief the `init` in @ref methods, or nullptr.
+  const Function *initializer = nullptr;
+  /// @brief the shape of a new instance, which has no fields.
+  Shape root_shape;
 
 public:
   Class(std::string_view,
-        uint_least32_t,
+        symbol_id_t,
         methods_t && = {},
-        std::string_view = {},
-        env_ptr_t = {});
+        IVisitor::variant_type = {});
+  Class(const Class &) = delete;
+  Class(Class &&) noexcept = default;
 
 public:
   auto arity() const -> unsigned override;
-  auto call(interpreter &, args_t &&) -> eval_result_t override;
+  /// @pre the class is held by a @ref lox::Value.
+  auto call(interpreter &, args_t) -> eval_result_t override;
 
 public:
-  auto get_method(std::string_view) const -> auxilia::StatusOr<Function>;
-  auto get_superclass() const [[clang::lifetimebound]] -> Class *;
+  /// @note the token's lexeme and line are only used for the error message.
+  auto get_method(const Token &) const -> auxilia::StatusOr<Function>;
+  /// @return the method, inherited or not, or nullptr.
+  auto find_method(symbol_id_t) const [[clang::lifetimebound]]
+  -> const Function *;
+  auto get_superclass() const [[clang::lifetimebound]] -> const Class * {
+    return base;
+  }
+  auto get_root_shape() const [[clang::lifetimebound]] -> const Shape & {
+    return root_shape;
+  }
 
 public:
   auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
 
 private:
-  auto get_initializer() [[clang::lifetimebound]] -> Function *;
-
-private:
+  /// @note so are classes.
   friend inline auto operator==(const Class &lhs, const Class &rhs) -> bool {
-    return lhs.name == rhs.name && lhs.methods == rhs.methods;
+    return &lhs == &rhs;
   }
   friend inline auto operator!=(const Class &lhs, const Class &rhs) -> bool {
     return !(lhs == rhs);
   }
 };
-class Instance : public Evaluatable {
-  using field_t = std::pair<string_type, eval_result_t>;
-  using fields_t = std::unordered_map<string_type, eval_result_t>;
-  using fields_ptr_t = std::shared_ptr<fields_t>;
+class Instance : public Evaluatable, public Object {
+  using fields_t = std::vector<IVisitor::variant_type>;
   using env_t = Callable::env_t;
   using env_ptr_t = Callable::env_ptr_t;
 
 private:
-  /// @note the current design flaw was rather big, storing value in variant as
-  /// result was great until class and instance comes in, which is stateful and
-  /// if copied, we're changing the state of the copy, not the original.
-  ///
-  /// Currently i have neither no desire nor the time to change it, so I have to
-  /// use shared_ptr to store class_env and class fields.
-  ///
-  /// @todo weak_ptr seems not to be a proper choice!
-  /// If shared_ptr is used, then the env and values stored may have cyclic
-  /// strong reference: it'll fine for Function holds a strong ref to env, and
-  /// env holds a weak_ref to func, but its not the case for pure values like
-  /// String, Number etc; while the values are stored in env probably in a
-  /// type-erasure way.
-  fields_ptr_t fields;
-  /// @note this is a bit of a hack, but it works for now.
-  /// We ought to store a (strong) reference to the Class object, but the class
-  /// object was inside variant and the unordered_map might move it when
-  /// rehashing; if the env was destroyed, the class object would be destroyed
-  /// too, but in language like js and C++, the class still works even if the
-  /// class was not visible outside a scope (in a word, classes defined in scope
-  /// only affect its usage for the user, restricting it in a specific scope,
-  /// much like a define-ed and undef-ed macro in C), the instance might
-  /// outlive. So we have to make it a strong reference.
-  env_ptr_t class_env;
-  /// @note class name won't change(stateless), so we can store it as a value.
-  string_type class_name;
-
-public:
-  explicit Instance(const env_ptr_t &, std::string_view);
-
-public:
-  auto get_field(std::string_view) const -> eval_result_t;
-  auto set_field(std::string_view, eval_result_t &&, bool = false)
+  /// @brief the values of the fields, in the slots @ref shape assigns.
+  /// @note an instance is only ever reached through the @ref lox::Value that
+  /// holds it, so fields are stored in place and not copied.
+  fields_t fields;
+  /// @note in language like js and C++, the class still works even if the
+  /// class was not visible outside a scope (classes defined in scope only
+  /// affect its usage for the user), the instance might outlive it, so we keep
+  /// a strong reference to the class value.
+  IVisitor::variant_type klass;
+  /// @brief owned by the class.
+  const Shape *shape;
+
+public:
+  /// @pre @p klass holds a Class.
+  explicit Instance(IVisitor::variant_type klass);
+  Instance(const Instance &) = delete;
+  Instance(Instance &&) noexcept = default;
+
+public:
+  /// @note the tokens' lexemes and lines are only used for error messages.
+  auto get_field(const Token &) const -> eval_result_t;
+  auto set_field(const Token &, eval_result_t &&, bool = false)
       -> auxilia::Status;
   auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
 
-private:
-  auto get_class() const -> Class &;
+public:
+  /// @name slot access, for the inline caches of the interpreter.
+  /// @{
+  auto get_shape() const noexcept -> const Shape & { return *shape; }
+  /// @pre @p slot is a slot of the instance's shape.
+  auto field_at(const size_t slot) noexcept -> IVisitor::variant_type & {
+    return fields[slot];
+  }
+  /// @pre @p next is the transition from the instance's shape.
+  auto add_field(const Shape *next, IVisitor::variant_type &&value) -> void {
+    shape = next;
+    fields.emplace_back(std::move(value));
+  }
+  /// @}
+  /// @note the class the instance was made from, whatever its name now refers
+  /// to.
+  auto get_class() const noexcept -> const Class & {
+    return klass.get<Class>();
+  }
 
 private:
+  /// @note instances are references: one is only equal to itself.
   friend auto operator==(const Instance &lhs, const Instance &rhs) {
-    return lhs.get_class() == rhs.get_class()
-        // && lhs.fields == rhs.fields  // compile error
-        ;
+    return &lhs == &rhs;
   }
   friend auto operator!=(const Instance &lhs, const Instance &rhs) {
     return !(lhs == rhs);
   }
 };
 } // namespace accat::lox::evaluation
+/// @brief uses the hash the string caches.
+template <> struct std::hash<accat::lox::evaluation::String> {
+  auto operator()(const accat::lox::evaluation::String &string) const
+      -> size_t {
+    return string.hash();
+  }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 #include <accat/auxilia/auxilia.hpp>
@@ -9,9 +10,10 @@
 
 #include "details/IVisitor.hpp"
 #include "Evaluatable.hpp"
+#include "expression.hpp"
 namespace accat::lox::expression {
 /// @interface ExprVisitor
-class ExprVisitor : virtual public IVisitor {
+class ExprVisitor : public IVisitor {
 public:
   virtual ~ExprVisitor() = default;
 
@@ -22,18 +24,48 @@ public:
   ///      function private, but coreguidelines says it's a good practice.
   /// @note see <a href="https://stackoverflow.com/questions/2170688/private-virtual-method-in-c">here</a>
   // clang-format on
-  template <typename DerivedExpr>
-    requires std::is_base_of_v<Expr, DerivedExpr>
-  auto visit(const DerivedExpr &expr) const {
-    // workaround
-    return const_cast<ExprVisitor *>(this)->visit2(expr);
-  }
   auto evaluate(const Expr &expr) const {
     // workaround
     return const_cast<ExprVisitor *>(this)->evaluate4(expr);
   }
   auto get_result() const { return get_result_impl(); }
 
+protected:
+  /// @brief call the visitor's own `visit2` for the node's kind: one switch on
+  /// its tag in place of a double dispatch through virtual calls.
+  /// @note deducing this gives the final visitor's type, and the visitors
+  /// befriend this class, so the call is direct.
+  auto dispatch(this auto &self, const Expr &expr) -> eval_result_t {
+    using enum Expr::Kind;
+    switch (expr.kind) {
+    case kLiteral:
+      return self.visit2(static_cast<const Literal &>(expr));
+    case kUnary:
+      return self.visit2(static_cast<const Unary &>(expr));
+    case kBinary:
+      return self.visit2(static_cast<const Binary &>(expr));
+    case kGrouping:
+      return self.visit2(static_cast<const Grouping &>(expr));
+    case kVariable:
+      return self.visit2(static_cast<const Variable &>(expr));
+    case kAssignment:
+      return self.visit2(static_cast<const Assignment &>(expr));
+    case kLogical:
+      return self.visit2(static_cast<const Logical &>(expr));
+    case kCall:
+      return self.visit2(static_cast<const Call &>(expr));
+    case kGet:
+      return self.visit2(static_cast<const Get &>(expr));
+    case kSet:
+      return self.visit2(static_cast<const Set &>(expr));
+    case kThis:
+      return self.visit2(static_cast<const This &>(expr));
+    case kSuper:
+      return self.visit2(static_cast<const Super &>(expr));
+    }
+    std::unreachable();
+  }
+
 private:
   virtual auto visit2(const Literal &) -> eval_result_t = 0;
   virtual auto visit2(const Unary &) -> eval_result_t = 0;
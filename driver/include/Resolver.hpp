@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <stack>
 
 #include "details/lox_fwd.hpp"
@@ -8,17 +9,44 @@
 #include "details/IVisitor.hpp"
 #include "ExprVisitor.hpp"
 #include "StmtVisitor.hpp"
+#include "interpreter.hpp"
 
 namespace accat::lox {
-class AC_LOX_API Resolver : auxilia::Printable,
-                          virtual public expression::ExprVisitor,
-                          virtual public statement::StmtVisitor,
-                          public std::enable_shared_from_this<Resolver> {
+class AC_LOX_API Resolver final : auxilia::Printable,
+                                public expression::ExprVisitor,
+                                public statement::StmtVisitor,
+                                public std::enable_shared_from_this<Resolver> {
+  friend expression::ExprVisitor;
+  friend statement::StmtVisitor;
+  using expression::ExprVisitor::dispatch;
+  using statement::StmtVisitor::dispatch;
+
 public:
   explicit Resolver(class ::accat::lox::interpreter &interpreter);
   virtual ~Resolver() override = default;
-  using scope_t = std::unordered_map<std::string, bool>;
+  using location_t = ::accat::lox::interpreter::location_t;
+  /// @brief a local declared in a scope: the slot it occupies in the frame of
+  /// its function, and whether its initializer has been resolved.
+  struct local_t {
+    size_t slot;
+    bool is_defined;
+    bool is_captured = false;
+    /// @brief where it's used from its own function; moved to a cell if a
+    /// closure captures it.
+    std::vector<location_t *> uses = {};
+  };
+  using scope_t = std::unordered_map<symbol_id_t, local_t>;
   using scopes_t = std::vector<scope_t>;
+  /// @brief a function being resolved: the index of its outermost scope in
+  /// `scopes`, the next free slot of its frame and how many of them the
+  /// receiver and the parameters take.
+  /// @note the top-level code is the function at index 0.
+  struct function_t {
+    size_t scope_base;
+    size_t next_slot = 0;
+    size_t parameter_slots = 0;
+    ::accat::lox::interpreter::frame_t frame = {};
+  };
 
 private:
   enum class ScopeType : std::uint8_t {
@@ -36,21 +64,35 @@ private:
 private:
   class ::accat::lox::interpreter &interpreter;
   scopes_t scopes;
+  std::vector<function_t> functions = {function_t{.scope_base = 0}};
   ScopeType current_scope_type = ScopeType::kNone;
   ClassType current_class_type = ClassType::kNone;
 
 public:
-  auto resolve(std::span<const std::shared_ptr<statement::Stmt>>) const
+  /// @note hide the bases' own, as the interpreter does.
+  auto evaluate(const expression::Expr &expr) const -> eval_result_t {
+    return const_cast<Resolver *>(this)->evaluate4(expr);
+  }
+  auto execute(const statement::Stmt &stmt) const -> exec_result_t {
+    return const_cast<Resolver *>(this)->execute4(stmt);
+  }
+  auto resolve(std::span<statement::Stmt *const>) const
       -> eval_result_t;
 
 private:
   auto resolve(const statement::Function &, ScopeType) -> eval_result_t;
-  auto resolve_to_interp(const std::shared_ptr<const expression::Expr> &,
-                         const Token &) -> eval_result_t;
+  auto resolve_to_interp(const expression::Expr &, const Token &)
+      -> eval_result_t;
+  auto resolve_to_interp(const statement::Stmt &, const Token &)
+      -> eval_result_t;
+  auto lookup(symbol_id_t) -> std::optional<std::pair<location_t, local_t *>>;
+  auto locate(size_t, size_t, size_t) -> location_t;
+  void bind(location_t &, local_t *);
   void declare(const Token &);
   void define(const Token &);
   bool is_defined(const Token &) const;
-  void add_to_scope(const Token &, bool);
+  void add_to_scope(symbol_id_t, bool);
+  void end_scope();
 
 private:
   auto visit2(const expression::Literal &) -> eval_result_t override;
@@ -69,17 +111,17 @@ private:
   auto get_result_impl() const -> eval_result_t override;
 
 private:
-  auto visit2(const statement::Variable &) -> eval_result_t override;
-  auto visit2(const statement::Print &) -> eval_result_t override;
-  auto visit2(const statement::Expression &) -> eval_result_t override;
-  auto visit2(const statement::Block &) -> eval_result_t override;
-  auto visit2(const statement::If &) -> eval_result_t override;
-  auto visit2(const statement::While &) -> eval_result_t override;
-  auto visit2(const statement::For &) -> eval_result_t override;
-  auto visit2(const statement::Function &) -> eval_result_t override;
-  auto visit2(const statement::Class &) -> eval_result_t override;
-  auto visit2(const statement::Return &) -> eval_result_t override;
-  auto execute4(const statement::Stmt &) -> eval_result_t override;
+  auto visit2(const statement::Variable &) -> exec_result_t override;
+  auto visit2(const statement::Print &) -> exec_result_t override;
+  auto visit2(const statement::Expression &) -> exec_result_t override;
+  auto visit2(const statement::Block &) -> exec_result_t override;
+  auto visit2(const statement::If &) -> exec_result_t override;
+  auto visit2(const statement::While &) -> exec_result_t override;
+  auto visit2(const statement::For &) -> exec_result_t override;
+  auto visit2(const statement::Function &) -> exec_result_t override;
+  auto visit2(const statement::Class &) -> exec_result_t override;
+  auto visit2(const statement::Return &) -> exec_result_t override;
+  auto execute4(const statement::Stmt &) -> exec_result_t override;
 
 public:
   auto to_string(const auxilia::FormatPolicy & =
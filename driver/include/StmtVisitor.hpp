@@ -2,6 +2,7 @@
 #define lox_STMTVISITOR_HPP
 #include <variant>
 #include <cmath>
+#include <utility>
 
 #include <accat/auxilia/auxilia.hpp>
 
@@ -9,35 +10,62 @@
 #include "details/IVisitor.hpp"
 
 #include "Evaluatable.hpp"
+#include "statement.hpp"
 
 namespace accat::lox::statement {
 /// @implements auxilia::Printable
 /// @interface StmtVisitor
-class StmtVisitor : virtual public IVisitor {
+class StmtVisitor : public IVisitor {
 public:
-  template <typename DerivedStmt>
-    requires std::is_base_of_v<Stmt, DerivedStmt>
-  auto visit(const DerivedStmt &stmt) const {
-    // workaround
-    return const_cast<StmtVisitor *>(this)->visit2(stmt);
-  }
   auto execute(const Stmt &stmt) const {
     // workaround
     return const_cast<StmtVisitor *>(this)->execute4(stmt);
   }
 
+protected:
+  /// @brief call the visitor's own `visit2` for the node's kind: one switch on
+  /// its tag in place of a double dispatch through virtual calls.
+  /// @note deducing this gives the final visitor's type, and the visitors
+  /// befriend this class, so the call is direct.
+  auto dispatch(this auto &self, const Stmt &stmt) -> exec_result_t {
+    using enum Stmt::Kind;
+    switch (stmt.kind) {
+    case kVariable:
+      return self.visit2(static_cast<const Variable &>(stmt));
+    case kPrint:
+      return self.visit2(static_cast<const Print &>(stmt));
+    case kExpression:
+      return self.visit2(static_cast<const Expression &>(stmt));
+    case kBlock:
+      return self.visit2(static_cast<const Block &>(stmt));
+    case kIf:
+      return self.visit2(static_cast<const If &>(stmt));
+    case kWhile:
+      return self.visit2(static_cast<const While &>(stmt));
+    case kFor:
+      return self.visit2(static_cast<const For &>(stmt));
+    case kFunction:
+      return self.visit2(static_cast<const Function &>(stmt));
+    case kClass:
+      return self.visit2(static_cast<const Class &>(stmt));
+    case kReturn:
+      return self.visit2(static_cast<const Return &>(stmt));
+    }
+    std::unreachable();
+  }
+
 private:
-  virtual eval_result_t visit2(const Variable &) = 0;
-  virtual eval_result_t visit2(const Print &) = 0;
-  virtual eval_result_t visit2(const Expression &) = 0;
-  virtual eval_result_t visit2(const Block &) = 0;
-  virtual eval_result_t visit2(const If &) = 0;
-  virtual eval_result_t visit2(const While &) = 0;
-  virtual eval_result_t visit2(const For &) = 0;
-  virtual eval_result_t visit2(const Function &) = 0;
-  virtual eval_result_t visit2(const Class &) = 0;
-  virtual eval_result_t visit2(const Return &) = 0;
-  virtual eval_result_t execute4(const Stmt &) = 0;
+  virtual exec_result_t visit2(const Variable &) = 0;
+  virtual exec_result_t visit2(const Print &) = 0;
+  virtual exec_result_t visit2(const Expression &) = 0;
+  virtual exec_result_t visit2(const Block &) = 0;
+  virtual exec_result_t visit2(const If &) = 0;
+  virtual exec_result_t visit2(const While &) = 0;
+  virtual exec_result_t visit2(const For &) = 0;
+  virtual exec_result_t visit2(const Function &) = 0;
+  virtual exec_result_t visit2(const Class &) = 0;
+  virtual exec_result_t visit2(const Return &) = 0;
+  virtual exec_result_t execute4(const Stmt &) = 0;
 
 public:
   virtual ~StmtVisitor() = default;
@@ -0,0 +1,64 @@
+#ifndef AC_LOX_SYMBOLTABLE_HPP
+#define AC_LOX_SYMBOLTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+namespace accat::lox {
+/// @brief interns identifier names into dense integer ids, so that name
+/// comparisons and hashes in the resolver and at runtime are integer
+/// operations.
+/// @note the lexer interns identifiers as it produces them; the table is then
+/// shared with the interpreter running the same program.
+/// @implements auxilia::Printable
+class AC_LOX_API SymbolTable : public auxilia::Printable {
+public:
+  using string_view_type = auxilia::string_view;
+  using symbol_type = symbol_id_t;
+  /// @brief well-known names, interned up front in this order.
+  enum : symbol_type {
+    kThis = 0,
+    kSuper,
+    kInit,
+    kClock,
+    kAbout,
+    kInvalid = std::numeric_limits<symbol_type>::max()
+  };
+
+public:
+  SymbolTable();
+  SymbolTable(const SymbolTable &) = delete;
+  auto operator=(const SymbolTable &) = delete;
+  SymbolTable(SymbolTable &&) noexcept = default;
+  auto operator=(SymbolTable &&) noexcept -> SymbolTable & = default;
+  ~SymbolTable() = default;
+
+public:
+  /// @return the id of @p name, assigning the next one if it's new.
+  auto intern(string_view_type) -> symbol_type;
+  /// @return the id of @p name, or @ref kInvalid if it was never interned.
+  auto find(string_view_type) const -> symbol_type;
+  auto name_of(symbol_type) const -> string_view_type;
+  auto size() const noexcept -> size_t { return names.size(); }
+
+private:
+  /// @note deque: elements never move, so the views in @ref ids stay valid.
+  std::deque<string_type> names;
+  std::unordered_map<string_view_type, symbol_type> ids;
+
+public:
+  auto to_string(const auxilia::FormatPolicy & =
+                     auxilia::FormatPolicy::kDefault) const -> string_type;
+};
+} // namespace accat::lox
+
+#endif // AC_LOX_SYMBOLTABLE_HPP
@@ -12,6 +12,7 @@
 #include "accat/auxilia/details/Variant.hpp"
 #include "accat/auxilia/details/format.hpp"
 #include "details/lox_fwd.hpp"
+#include "SymbolTable.hpp"
 
 #ifdef AC_LOX_DETAILS_TOKENTYPE_HPP
 #  error                                                                       \
@@ -21,6 +22,34 @@
 #include "details/lex_error.hpp"
 
 namespace accat::lox {
+/// @brief a token as the lexer keeps it: what it is and where its lexeme lies
+/// in the source, in 16 bytes.
+/// @note the lexeme, the literal and the line are not stored but read back from
+/// the source by @ref lexer::materialize, which makes a @ref Token of it.
+class AC_LOX_API CompactToken {
+public:
+  using token_type = TokenType;
+  using error_t = lex_error;
+
+public:
+  constexpr auto is_type(const token_type &type) const noexcept -> bool {
+    return this->type == type;
+  }
+
+public:
+  /// @brief the type of the token
+  token_type type{TokenType::kMonostate};
+  /// @brief what went wrong, for lex errors
+  error_t::type_t error = error_t::kMonostate;
+  /// @brief where the lexeme starts in the source
+  uint32_t offset = 0;
+  /// @brief the length of the lexeme
+  uint32_t length = 0;
+  /// @brief see @ref Token::symbol
+  symbol_id_t symbol = SymbolTable::kInvalid;
+};
+static_assert(sizeof(CompactToken) == 16);
+
 class AC_LOX_API Token : public auxilia::Printable {
 public:
   using token_type = TokenType;
@@ -29,7 +58,7 @@ public:
   using literal_type = auxilia::Variant<auxilia::Monostate,
                                         string_view_type,
                                         long long,
-                                        long double,
+                                        double,
                                         bool,
                                         error_t>;
 
@@ -55,13 +84,16 @@ public:
 public:
   /// @brief the type of the token
   token_type type{TokenType::kMonostate};
-  /// @brief the lexeme. (the actual string)
-  string_type lexeme;
+  /// @brief the lexeme. (the actual string, viewed in the lexer's source)
+  string_view_type lexeme;
   /// @brief the literal value of the token
   literal_type literal;
   /// @brief the line number where the token is found
   uint_least32_t line = std::numeric_limits<
       std::underlying_type_t<enum token_type::type_t>>::signaling_NaN();
+  /// @brief interned name of identifiers, `this` and `super`, and the
+  /// interned contents of string literals.
+  symbol_id_t symbol = SymbolTable::kInvalid;
 
 private:
   friend auto format_as(const Token &token) -> Token::string_type {
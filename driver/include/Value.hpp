@@ -0,0 +1,282 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+namespace accat::lox {
+class Value;
+namespace evaluation {
+/// @brief the part of a heap-allocated value a @ref lox::Value points to: an
+/// intrusive reference count.
+/// @note a copy of an object is a new object, so the count is not copied.
+class Object {
+  friend class ::accat::lox::Value;
+
+protected:
+  constexpr Object() noexcept = default;
+  constexpr Object(const Object &) noexcept {}
+  constexpr auto operator=(const Object &) noexcept -> Object & {
+    return *this;
+  }
+  constexpr ~Object() noexcept = default;
+
+private:
+  mutable uint_least32_t refcount = 0;
+};
+} // namespace evaluation
+/// @brief a value of the language in 64 bits (NaN-boxing).
+///
+/// Numbers are stored as the bits of their double; every other value lives in
+/// the payload of a quiet NaN no arithmetic produces (NaN results are
+/// canonicalized when boxed):
+/// - `nil`, `true`, `false` and the empty value are immediates;
+/// - an integral @ref evaluation::Number that fits the 48-bit payload is an
+///   immediate too, tagged by bit 48, so it stays on the integer fast path;
+/// - strings, functions, classes and instances are heap objects, the sign bit
+///   set, their kind in bits 48-49 and the pointer in the low 48 bits. They
+///   are reference counted; copying a Value shares the object.
+///
+/// @note the interface mirrors the `auxilia::Variant` it replaced: `index()`
+/// keeps its order and `get` returns immediates by value and objects by
+/// reference.
+class AC_LOX_API Value : public auxilia::Printable {
+  using bits_t = std::uint64_t;
+  using Object = evaluation::Object;
+
+  enum class Kind : bits_t {
+    kString = 0,
+    kFunction,
+    kClass,
+    kInstance,
+  };
+
+  static constexpr bits_t kSign = 0x8000'0000'0000'0000;
+  static constexpr bits_t kQuietNaN = 0x7ffc'0000'0000'0000;
+  static constexpr bits_t kObjectTag = kSign | kQuietNaN;
+  static constexpr bits_t kKindShift = 48;
+  static constexpr bits_t kKindMask = bits_t{3} << kKindShift;
+  static constexpr bits_t kPointerMask = 0x0000'ffff'ffff'ffff;
+  static constexpr bits_t kCanonicalNaN = 0x7ff8'0000'0000'0000;
+  static constexpr bits_t kTagMask = 0xffff'0000'0000'0000;
+  static constexpr bits_t kInteger = kQuietNaN | bits_t{1} << kKindShift;
+  static constexpr bits_t kIntegerMask = kPointerMask;
+  /// @brief how far a 48-bit payload is shifted to sign-extend it.
+  static constexpr auto kIntegerShift = static_cast<int>(64 - kKindShift);
+
+  static constexpr bits_t kEmpty = kQuietNaN;
+  static constexpr bits_t kNil = kQuietNaN | 1;
+  static constexpr bits_t kFalse = kQuietNaN | 2;
+  static constexpr bits_t kTrue = kQuietNaN | 3;
+
+  template <typename T>
+  static constexpr bool is_object_type_v =
+      std::is_same_v<T, evaluation::String> ||
+      std::is_same_v<T, evaluation::Function> ||
+      std::is_same_v<T, evaluation::Class> ||
+      std::is_same_v<T, evaluation::Instance>;
+
+  template <typename T>
+  static constexpr bool is_alternative_v =
+      is_object_type_v<T> || std::is_same_v<T, auxilia::Monostate> ||
+      std::is_same_v<T, evaluation::Boolean> ||
+      std::is_same_v<T, evaluation::Nil> ||
+      std::is_same_v<T, evaluation::Number>;
+
+  template <typename T> static consteval auto kind_of() noexcept -> Kind {
+    if constexpr (std::is_same_v<T, evaluation::String>)
+      return Kind::kString;
+    else if constexpr (std::is_same_v<T, evaluation::Function>)
+      return Kind::kFunction;
+    else if constexpr (std::is_same_v<T, evaluation::Class>)
+      return Kind::kClass;
+    else
+      return Kind::kInstance;
+  }
+
+public:
+  constexpr Value() noexcept = default;
+  template <typename T>
+    requires is_alternative_v<std::remove_cvref_t<T>>
+  Value(T &&value) {
+    using type = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<type, auxilia::Monostate>)
+      bits = kEmpty;
+    else if constexpr (std::is_same_v<type, evaluation::Nil>)
+      bits = kNil;
+    else if constexpr (std::is_same_v<type, evaluation::Boolean>)
+      bits = value.is_true() ? kTrue : kFalse;
+    else if constexpr (std::is_same_v<type, evaluation::Number>)
+      bits = value.is_integral() ? box(value.get_integer())
+                                 : box(value.get_value());
+    else
+      bits = box(new type(std::forward<T>(value)), kind_of<type>());
+  }
+  Value(const Value &that) noexcept : bits(that.bits) { retain(); }
+  Value(Value &&that) noexcept : bits(std::exchange(that.bits, kEmpty)) {}
+  auto operator=(const Value &that) noexcept -> Value & {
+    that.retain();
+    release();
+    bits = that.bits;
+    return *this;
+  }
+  auto operator=(Value &&that) noexcept -> Value & {
+    if (this != &that) {
+      release();
+      bits = std::exchange(that.bits, kEmpty);
+    }
+    return *this;
+  }
+  ~Value() noexcept { release(); }
+  /// @return another reference to @p object, which is not copied.
+  /// @pre @p object is held by a Value, as `*this` of a class being called or
+  /// an instance a method is bound to is.
+  template <typename T>
+    requires is_object_type_v<T>
+  static auto share(const T &object) noexcept -> Value {
+    contract_assert(static_cast<const Object &>(object).refcount != 0,
+                    "the object is not held by a Value")
+    auto value = Value{};
+    value.bits = box(&object, kind_of<T>());
+    return value;
+  }
+
+public:
+  template <typename T>
+    requires is_alternative_v<T>
+  auto is_type() const noexcept -> bool {
+    if constexpr (std::is_same_v<T, auxilia::Monostate>)
+      return bits == kEmpty;
+    else if constexpr (std::is_same_v<T, evaluation::Nil>)
+      return bits == kNil;
+    else if constexpr (std::is_same_v<T, evaluation::Boolean>)
+      return bits == kTrue || bits == kFalse;
+    else if constexpr (std::is_same_v<T, evaluation::Number>)
+      return is_number();
+    else
+      return is_object() && kind() == kind_of<T>();
+  }
+  /// @pre `is_type<T>()`
+  template <typename T>
+    requires is_alternative_v<T>
+  auto get() const -> decltype(auto) {
+    if constexpr (std::is_same_v<T, auxilia::Monostate>)
+      return auxilia::Monostate{};
+    else if constexpr (std::is_same_v<T, evaluation::Nil>)
+      return T{};
+    else if constexpr (std::is_same_v<T, evaluation::Boolean>)
+      return T{bits == kTrue};
+    else if constexpr (std::is_same_v<T, evaluation::Number>)
+      return is_integer() ? T{get_integer()} : T{std::bit_cast<double>(bits)};
+    else
+      return static_cast<T &>(*object());
+  }
+  template <typename T>
+    requires is_object_type_v<T>
+  auto get_if() const noexcept -> T * {
+    return is_type<T>() ? static_cast<T *>(object()) : nullptr;
+  }
+  constexpr auto empty() const noexcept -> bool { return bits == kEmpty; }
+  auto clear() noexcept -> void {
+    release();
+    bits = kEmpty;
+  }
+  /// @return the position the type had in the variant: Monostate, Boolean,
+  /// Nil, Number, String, Function, Class, Instance.
+  constexpr auto index() const noexcept -> size_t {
+    if (is_number())
+      return 3;
+    if (is_object())
+      return 4 + static_cast<size_t>(kind());
+    if (bits == kEmpty)
+      return 0;
+    return bits == kNil ? 2 : 1;
+  }
+  /// @return false for `nil` and `false` only.
+  constexpr auto is_truthy() const noexcept -> bool {
+    return bits != kNil && bits != kFalse;
+  }
+
+public:
+  auto to_string(const auxilia::FormatPolicy & =
+                     auxilia::FormatPolicy::kDefault) const -> string_type;
+
+private:
+  /// @note numbers compare by value (NaN is unequal to itself), objects by
+  /// identity first and then as their types define it.
+  friend auto operator==(const Value &lhs, const Value &rhs) noexcept -> bool {
+    if (lhs.is_integer() && rhs.is_integer())
+      return lhs.bits == rhs.bits;
+    if (lhs.is_number() && rhs.is_number())
+      return lhs.get_double() == rhs.get_double();
+    if (lhs.bits == rhs.bits)
+      return true;
+    if (lhs.is_object() && rhs.is_object() && lhs.kind() == rhs.kind())
+      return equal_objects(lhs, rhs);
+    return false;
+  }
+
+private:
+  constexpr auto is_double() const noexcept -> bool {
+    return (bits & kQuietNaN) != kQuietNaN;
+  }
+  constexpr auto is_integer() const noexcept -> bool {
+    return (bits & kTagMask) == kInteger;
+  }
+  constexpr auto is_number() const noexcept -> bool {
+    return is_double() || is_integer();
+  }
+  constexpr auto get_integer() const noexcept -> std::int64_t {
+    return static_cast<std::int64_t>(bits << kIntegerShift) >> kIntegerShift;
+  }
+  /// @pre `is_number()`
+  constexpr auto get_double() const noexcept -> double {
+    return is_integer() ? static_cast<double>(get_integer())
+                        : std::bit_cast<double>(bits);
+  }
+  constexpr auto is_object() const noexcept -> bool {
+    return (bits & kObjectTag) == kObjectTag;
+  }
+  constexpr auto kind() const noexcept -> Kind {
+    return static_cast<Kind>((bits & kKindMask) >> kKindShift);
+  }
+  auto object() const noexcept -> Object * {
+    return reinterpret_cast<Object *>(bits & kPointerMask);
+  }
+  static auto box(const double number) noexcept -> bits_t {
+    return std::isnan(number) ? kCanonicalNaN : std::bit_cast<bits_t>(number);
+  }
+  static auto box(const std::int64_t integer) noexcept -> bits_t {
+    if (integer != integer << kIntegerShift >> kIntegerShift)
+      return box(static_cast<double>(integer));
+    return kInteger | (static_cast<bits_t>(integer) & kIntegerMask);
+  }
+  static auto box(const Object *object, const Kind kind) noexcept -> bits_t {
+    ++object->refcount;
+    return kObjectTag | (static_cast<bits_t>(kind) << kKindShift) |
+           reinterpret_cast<bits_t>(object);
+  }
+  auto retain() const noexcept -> void {
+    if (is_object())
+      ++object()->refcount;
+  }
+  auto release() noexcept -> void {
+    if (is_object() && --object()->refcount == 0)
+      destroy();
+  }
+  /// @note out of line: deleting an object needs its complete type.
+  auto destroy() noexcept -> void;
+  static auto equal_objects(const Value &, const Value &) -> bool;
+
+private:
+  bits_t bits = kEmpty;
+};
+static_assert(sizeof(Value) == sizeof(std::uint64_t));
+} // namespace accat::lox
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include <accat/auxilia/auxilia.hpp>
+#include "details/lox_fwd.hpp"
+
+namespace accat::lox {
+/// @brief how a statement completed: normally, by a `return`, or with an
+/// error.
+/// @note a statement has no value, so on the normal and the return path this
+/// is just a tag: the returned value waits in the interpreter, and the error
+/// is only allocated when one happens.
+class AC_LOX_API Completion {
+public:
+  enum class Kind : std::uint8_t {
+    kNormal = 0,
+    kReturn,
+    kError,
+  };
+
+public:
+  constexpr Completion() noexcept = default;
+  /// @note implicit: a statement completes with the status of what it ran.
+  Completion(const auxilia::Status &status) {
+    if (status.ok())
+      return;
+    if (status.is_return()) {
+      kind = Kind::kReturn;
+      return;
+    }
+    kind = Kind::kError;
+    error = std::make_unique<auxilia::Status>(status);
+  }
+  Completion(Completion &&) noexcept = default;
+  Completion &operator=(Completion &&) noexcept = default;
+  ~Completion() = default;
+
+public:
+  static auto Return() noexcept -> Completion {
+    auto completion = Completion{};
+    completion.kind = Kind::kReturn;
+    return completion;
+  }
+
+public:
+  constexpr auto ok() const noexcept -> bool { return kind == Kind::kNormal; }
+  constexpr explicit operator bool() const noexcept { return ok(); }
+  constexpr auto is_return() const noexcept -> bool {
+    return kind == Kind::kReturn;
+  }
+  auto as_status() const -> auxilia::Status {
+    switch (kind) {
+    case Kind::kReturn:
+      return {auxilia::Status::kReturning};
+    case Kind::kError:
+      return *error;
+    default:
+      return {};
+    }
+  }
+
+private:
+  Kind kind = Kind::kNormal;
+  std::unique_ptr<auxilia::Status> error;
+};
+} // namespace accat::lox
@@ -1,22 +1,26 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include <accat/auxilia/auxilia.hpp>
 #include "lox_fwd.hpp"
+#include "Completion.hpp"
+#include "Value.hpp"
 
 namespace accat::lox {
 /// @brief Interface for the visitor pattern
 /// @interface IVisitor
 class IVisitor {
 public:
-  using variant_type = auxilia::Variant<auxilia::Monostate,
-                                        lox::evaluation::Boolean,
-                                        lox::evaluation::Nil,
-                                        lox::evaluation::Number,
-                                        lox::evaluation::String,
-                                        lox::evaluation::Function,
-                                        lox::evaluation::Class,
-                                        lox::evaluation::Instance>;
+  /// @see Value
+  using variant_type = lox::Value;
   using eval_result_t = auxilia::StatusOr<variant_type>;
+  /// @brief what executing a statement results in.
+  using exec_result_t = Completion;
+  /// @brief the variables a closure captured, shared with the frames that
+  /// declared them.
+  using upvalues_t = std::vector<std::shared_ptr<variant_type>>;
   using string_view_type = auxilia::string_view;
 };
 } // namespace accat::lox
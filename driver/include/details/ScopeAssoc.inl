@@ -26,9 +26,9 @@ public:
   using variant_type = IVisitor::variant_type;
   using string_view_type = IVisitor::string_view_type;
   using association_t =
-      std::pair<string_type, std::pair<variant_type, uint_least32_t>>;
+      std::pair<symbol_id_t, std::pair<variant_type, uint_least32_t>>;
   using associations_t =
-      std::unordered_map<string_type, std::pair<variant_type, uint_least32_t>>;
+      std::unordered_map<symbol_id_t, std::pair<variant_type, uint_least32_t>>;
 
 public:
   ScopeAssoc() = default;
@@ -39,20 +39,20 @@ public:
   auto operator=(ScopeAssoc &&that) noexcept -> ScopeAssoc & = default;
 
 private:
-  auto add(string_view_type,
+  auto add(symbol_id_t,
            const variant_type &,
            uint_least32_t = std::numeric_limits<uint_least32_t>::quiet_NaN())
       -> auxilia::Status;
   auto
-  add_symbol(string_view_type,
+  add_symbol(symbol_id_t,
              const variant_type &,
              uint_least32_t = std::numeric_limits<uint_least32_t>::quiet_NaN())
       -> auxilia::Status;
-  auto find(string_view_type) -> std::optional<associations_t::iterator>;
-  auto find(string_view_type) const
+  auto find(symbol_id_t) -> std::optional<associations_t::iterator>;
+  auto find(symbol_id_t) const
       -> std::optional<associations_t::const_iterator>;
-  auto find_symbol(string_view_type) -> std::optional<associations_t::iterator>;
-  auto find_symbol(string_view_type) const
+  auto find_symbol(symbol_id_t) -> std::optional<associations_t::iterator>;
+  auto find_symbol(symbol_id_t) const
       -> std::optional<associations_t::const_iterator>;
   bool is_symbol(const variant_type &) const;
 
@@ -59,7 +59,7 @@ lex_error::to_string(const string_view_t lexeme_sv,
     my_msg = "Internal error";
     break;
   case kUnexpectedCharacter:
-    my_msg = auxilia::format("Unexpected character: {}", lexeme_sv.data());
+    my_msg = auxilia::format("Unexpected character: {}", lexeme_sv);
     break;
   case kUnterminatedString:
     my_msg = "Unterminated string.";
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -36,6 +37,9 @@ class parse_error;
 
 class interpreter;
 class Environment;
+class SymbolTable;
+/// @brief compact id of an interned identifier; see @ref SymbolTable.
+using symbol_id_t = std::uint_least32_t;
 
 class Resolver;
 // NOLINTBEGIN(bugprone-forward-declaration-namespace)
@@ -80,6 +84,7 @@ class Boolean;
 class Nil;
 class Function;
 class Class;
+class Shape;
 class Instance;
 
 class ScopeAssoc;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -19,26 +21,42 @@
 /// @namespace accat::lox::expression
 namespace accat::lox::expression {
 /// @interface Expr
-class Expr : public auxilia::Printable,
-             public std::enable_shared_from_this<Expr> {
+/// @note nodes live in the @ref Arena of the program they were parsed from.
+class Expr : public auxilia::Printable {
 public:
   using base_type = Expr;
   using string_type = std::string;
   using ostream_t = std::ostream;
   using ostringstream_t = std::ostringstream;
   using token_t = Token;
-  using expr_ptr_t = std::shared_ptr<base_type>;
+  using expr_ptr_t = base_type *;
   using expr_result_t = IVisitor::eval_result_t;
 
+public:
+  /// @brief the concrete type of the node, which visitors switch on.
+  enum class Kind : std::uint8_t {
+    kLiteral,
+    kUnary,
+    kBinary,
+    kGrouping,
+    kVariable,
+    kAssignment,
+    kLogical,
+    kCall,
+    kGet,
+    kSet,
+    kThis,
+    kSuper,
+  };
+  const Kind kind;
+
+protected:
+  constexpr explicit Expr(const Kind kind) noexcept : kind(kind) {}
+
 public:
   virtual ~Expr() = default;
 
 public:
-  template <typename DerivedVisitor>
-    requires std::is_base_of_v<ExprVisitor, DerivedVisitor>
-  auto accept(const DerivedVisitor &visitor) const {
-    return accept2(visitor);
-  }
   auto operator==(const Expr &that) const -> bool {
     return this == &that ||
            // when it comes to overload equiality functions, that probably means
@@ -52,7 +70,6 @@ public:
       -> string_type = 0;
 
 private:
-  virtual expr_result_t accept2(const ExprVisitor &) const = 0;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool = 0;
 };
 /// @implements Expr
@@ -62,7 +79,6 @@ public:
   explicit Literal(token_t &&);
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return static_cast<const Literal &>(lhs).literal ==
@@ -75,6 +91,9 @@ public:
 
 public:
   token_t literal;
+  /// @brief what the literal evaluates to, made once when it's parsed; empty
+  /// if the token is not a literal.
+  IVisitor::variant_type value;
 };
 /// @implements Expr
 class Unary : public Expr {
@@ -84,7 +103,6 @@ public:
   virtual ~Unary() override = default;
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return static_cast<const Unary &>(lhs).op ==
@@ -99,7 +117,7 @@ public:
 
 public:
   token_t op;
-  expr_ptr_t expr;
+  expr_ptr_t expr = nullptr;
 };
 
 class Binary : public Expr {
@@ -109,7 +127,6 @@ public:
   virtual ~Binary() = default;
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return static_cast<const Binary &>(lhs).op ==
@@ -126,13 +143,13 @@ public:
 
 public:
   token_t op;
-  expr_ptr_t left;
-  expr_ptr_t right;
+  expr_ptr_t left = nullptr;
+  expr_ptr_t right = nullptr;
 };
 
 class Variable : public Expr {
 public:
-  constexpr Variable() = default;
+  constexpr Variable() : Expr(Kind::kVariable) {}
   explicit Variable(token_t &&);
   explicit Variable(const token_t &);
   virtual ~Variable() override = default;
@@ -141,7 +158,6 @@ public:
   token_t name;
 
 private:
-  auto accept2(const ExprVisitor &) const -> expr_result_t override;
 
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return static_cast<const Variable &>(lhs).name ==
@@ -158,7 +174,6 @@ public:
   virtual ~Grouping() = default;
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return *static_cast<const Grouping &>(lhs).expr ==
@@ -170,21 +185,20 @@ public:
       -> string_type override;
 
 public:
-  expr_ptr_t expr;
+  expr_ptr_t expr = nullptr;
 };
 /// @implements Expr
 class Assignment : public Expr {
 public:
-  constexpr Assignment() = default;
+  constexpr Assignment() : Expr(Kind::kAssignment) {}
   explicit Assignment(token_t &&, expr_ptr_t &&);
   virtual ~Assignment() override = default;
 
 public:
   token_t name;
-  expr_ptr_t value_expr;
+  expr_ptr_t value_expr = nullptr;
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return static_cast<const Assignment &>(lhs).name ==
@@ -200,17 +214,16 @@ public:
 /// @implements Expr
 class Logical : public Expr {
 public:
-  constexpr Logical() = default;
+  constexpr Logical() : Expr(Kind::kLogical) {}
   explicit Logical(token_t &&, expr_ptr_t &&, expr_ptr_t &&);
   virtual ~Logical() override = default;
 
 public:
   token_t op;
-  expr_ptr_t left;
-  expr_ptr_t right;
+  expr_ptr_t left = nullptr;
+  expr_ptr_t right = nullptr;
 
 private:
-  virtual auto accept2(const ExprVisitor &) const -> expr_result_t override;
   virtual auto doEqual(const Expr &lhs, const Expr &rhs) const
       -> bool override {
     return static_cast<const Logical &>(lhs).op.type ==
@@ -231,12 +244,14 @@ public:
   virtual ~Call() override = default;
 
 public:
-  expr_ptr_t callee;
+  expr_ptr_t callee = nullptr;
   token_t paren;
   std::vector<expr_ptr_t> args;
+  /// @brief the callee if it's a property access, so a method called right
+  /// away needn't be bound first.
+  const Get *property = nullptr;
 
 private:
-  expr_result_t accept2(const ExprVisitor &) const override;
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return *static_cast<const Call &>(lhs).callee ==
                *static_cast<const Call &>(rhs).callee &&
@@ -248,17 +263,53 @@ public:
   auto to_string(const auxilia::FormatPolicy &) const -> string_type override;
 };
 
+/// @brief an inline cache of a property access: what it found on the last
+/// few shapes of the instances it saw, so a hit costs one comparison.
+/// @note a shape belongs to one class, so it also tells which method a name
+/// not shadowed by a field refers to.
+struct PropertyCache {
+  struct entry_t {
+    const evaluation::Shape *shape = nullptr;
+    /// @brief the slot of the field; of the field being added, if @ref next.
+    size_t slot = 0;
+    /// @brief the method found instead of a field, if any.
+    const evaluation::Function *method = nullptr;
+    /// @brief the shape after adding the field, if the field was new.
+    const evaluation::Shape *next = nullptr;
+    /// @brief the class owning the shapes, kept alive so no other shape gets
+    /// allocated at their addresses.
+    IVisitor::variant_type klass;
+  };
+  /// @brief the number of shapes remembered; further ones replace the oldest.
+  static constexpr size_t capacity = 4;
+
+  auto find(const evaluation::Shape *shape) const noexcept -> const entry_t * {
+    for (auto i = 0uz; i < size; ++i)
+      if (entries[i].shape == shape)
+        return &entries[i];
+    return nullptr;
+  }
+  auto add(entry_t &&entry) -> const entry_t & {
+    auto &slot = entries[size < capacity ? size++ : oldest++ % capacity];
+    slot = std::move(entry);
+    return slot;
+  }
+
+  std::array<entry_t, capacity> entries{};
+  size_t size = 0;
+  size_t oldest = 0;
+};
 class Get : public Expr {
 public:
   Get(expr_ptr_t &&, token_t &&);
   virtual ~Get() override = default;
 
 public:
-  expr_ptr_t object;
+  expr_ptr_t object = nullptr;
   token_t field;
+  mutable PropertyCache cache;
 
 private:
-  auto accept2(const ExprVisitor &) const -> expr_result_t override;
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return *static_cast<const Get &>(lhs).object ==
                *static_cast<const Get &>(rhs).object &&
@@ -275,12 +326,12 @@ public:
   Set(expr_ptr_t &&, token_t &&, expr_ptr_t &&);
 
 public:
-  expr_ptr_t object;
+  expr_ptr_t object = nullptr;
   token_t field;
-  expr_ptr_t value;
+  expr_ptr_t value = nullptr;
+  mutable PropertyCache cache;
 
 private:
-  auto accept2(const ExprVisitor &) const -> expr_result_t override;
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return *static_cast<const Set &>(lhs).object ==
                *static_cast<const Set &>(rhs).object &&
@@ -303,7 +354,6 @@ public:
   token_t name; // always `this`
 
 private:
-  auto accept2(const ExprVisitor &) const -> expr_result_t override;
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return static_cast<const This &>(lhs).name ==
            static_cast<const This &>(rhs).name;
@@ -327,7 +377,6 @@ public:
   token_t method;
 
 private:
-  auto accept2(const ExprVisitor &) const -> expr_result_t override;
   auto doEqual(const Expr &lhs, const Expr &rhs) const -> bool override {
     return static_cast<const Super &>(lhs).name ==
                static_cast<const Super &>(rhs).name &&
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <expected>
 #include <unordered_map>
@@ -10,6 +11,7 @@
 #include <accat/auxilia/auxilia.hpp>
 #include <vector>
 
+#include "SymbolTable.hpp"
 #include "Token.hpp"
 #include "accat/auxilia/details/format.hpp"
 #include "details/lox_fwd.hpp"
@@ -41,64 +43,174 @@ namespace accat::lox {
 // };
 
 /// @implements expression::ExprVisitor
-class AC_LOX_API interpreter : public auxilia::Printable,
-                             virtual public expression::ExprVisitor,
-                             virtual public statement::StmtVisitor,
-                             std::enable_shared_from_this<interpreter> {
-  /// @note previously I use std::unordered_map<cexpr_ptr_t, size_t,
-  /// Hasher<...>, Equal<...>>, but it seems the `Equal` function will not be
-  /// called if we call `emplace`,`contains`, and `find`.
+class AC_LOX_API interpreter final : public auxilia::Printable,
+                                   public expression::ExprVisitor,
+                                   public statement::StmtVisitor,
+                                   std::enable_shared_from_this<interpreter> {
+  friend expression::ExprVisitor;
+  friend statement::StmtVisitor;
+  using expression::ExprVisitor::dispatch;
+  using statement::StmtVisitor::dispatch;
+
+  /// @brief side table of resolved local variables, keyed by the identity of
+  /// the AST node the Resolver visited: a variable use maps to the depth and
+  /// slot it refers to, a local declaration to the slot it occupies.
+  /// @note previously this was a linear scan comparing expressions deeply
+  /// (`Expr::operator==`) on every variable access, which made a local read
+  /// O(number of resolved expressions). The Resolver and the interpreter walk
+  /// the very same AST nodes, so the node's address is a unique key, but only
+  /// while the node lives: when streaming, the parser rewinds its arena after
+  /// each statement it doesn't keep and the next one reuses those addresses,
+  /// so the statement's entries must be rolled back (@ref rollback, through
+  /// `interpreter::retire`) before anything new is resolved.
   struct ResolvedEnv : Printable {
-    using cexpr_ptr_t = std::shared_ptr<const expression::Expr>;
-    using resolved_env_t = std::unordered_map<cexpr_ptr_t, size_t>;
+    /// @note locals are slots of the frame of the function they're declared
+    /// in(depth 0), or, if a closure captures them, cells in those slots
+    /// (@ref cell_depth). Globals are slots of the global environment
+    /// (@ref global_depth); captured variables of an enclosing function are
+    /// marked by @ref upvalue_depth, the slot being the upvalue index.
+    struct location_t {
+      static constexpr auto global_depth = std::numeric_limits<size_t>::max();
+      static constexpr auto upvalue_depth = global_depth - 1;
+      static constexpr auto cell_depth = upvalue_depth - 1;
+      size_t depth;
+      size_t slot;
+      auto operator==(const location_t &) const -> bool = default;
+    };
+    using key_type = const void *;
+    using resolved_env_t = std::unordered_map<key_type, location_t>;
 
   private:
     resolved_env_t realLocalEnv;
+    /// @brief the nodes recorded since the last @ref commit, if journaling.
+    std::vector<key_type> journal;
 
   public:
-    auto find(this auto &&self, const cexpr_ptr_t &expr) {
-      for (auto it = self.realLocalEnv.begin(); it != self.realLocalEnv.end();
-           ++it) {
-        if (*it->first == *expr) {
-          return it;
-        }
-      }
-      return self.realLocalEnv.end();
+    bool journaling = false;
+
+  public:
+    auto find(this auto &&self, const auto &node) {
+      return self.realLocalEnv.find(
+          static_cast<key_type>(std::addressof(node)));
     }
-    bool emplace(const cexpr_ptr_t &expr, const size_t &depth) {
-      if (find(expr) == realLocalEnv.end())
-        return realLocalEnv.emplace(expr, depth).second;
-      return false;
+    /// @return the location recorded for the node; the reference stays valid
+    /// as more nodes are added.
+    auto emplace(const auto &node, const location_t &location) -> location_t & {
+      const auto key = static_cast<key_type>(std::addressof(node));
+      const auto [it, inserted] = realLocalEnv.try_emplace(key, location);
+      if (inserted && journaling)
+        journal.emplace_back(key);
+      return it->second;
+    }
+    /// @brief keep what was recorded since the last commit.
+    void commit() noexcept { journal.clear(); }
+    /// @brief forget what was recorded since the last commit: those nodes are
+    /// freed, and their addresses may be reused by new ones.
+    void rollback() {
+      for (const auto key : journal)
+        realLocalEnv.erase(key);
+      journal.clear();
     }
     dbg_only([[gnu::used]])
-    auto to_string(const auxilia::FormatPolicy &format_policy =
+    auto to_string(const auxilia::FormatPolicy & =
                        auxilia::FormatPolicy::kDefault) const -> string_type {
       ostringstream_t oss;
-      for (const auto &[expr, depth] : realLocalEnv) {
-        oss << expr->to_string(format_policy) << " : " << depth << "\n";
+      for (const auto &[node, location] : realLocalEnv) {
+        oss << node << " : " << location.depth << ", " << location.slot
+            << "\n";
       }
       return oss.str();
     }
     auto end(this auto &&self) { return self.realLocalEnv.end(); }
-    auto contains(this auto &&self, const cexpr_ptr_t &expr) -> bool {
-      return self.realLocalEnv.find(expr) != self.realLocalEnv.end();
+    auto contains(this auto &&self, const auto &node) -> bool {
+      return self.realLocalEnv.contains(
+          static_cast<key_type>(std::addressof(node)));
     }
   };
 
 public:
-  interpreter();
+  explicit interpreter(
+      std::shared_ptr<SymbolTable> = std::make_shared<SymbolTable>());
   virtual ~interpreter() override = default;
   using ostringstream_t = std::ostringstream;
   using env_t = Environment;
   using env_ptr_t = std::shared_ptr<env_t>;
   using local_env_t = ResolvedEnv;
-  using cexpr_ptr_t = local_env_t::cexpr_ptr_t;
+  using location_t = local_env_t::location_t;
+  using upvalues_t = IVisitor::upvalues_t;
+  /// @brief the layout of a function's frame, computed by the Resolver.
+  struct frame_t {
+    /// @brief slots of the frame: the receiver, the parameters and the locals
+    /// of every block in the function, reused by sibling blocks.
+    size_t size = 0;
+    /// @brief the receiver or parameters captured by a closure.
+    std::vector<size_t> captured_parameters;
+    /// @brief the outer variables the function uses, in upvalue order; each is
+    /// located relative to the frame the function is declared in.
+    std::vector<location_t> captures;
+  };
+
+  /// @brief how the inline caches of property accesses fared.
+  struct cache_stats_t {
+    size_t hits = 0;
+    size_t misses = 0;
+  };
 
 public:
-  eval_result_t interpret(std::span<std::shared_ptr<statement::Stmt>>);
+  /// @note hide the bases' own: the interpreter is final, so a node it
+  /// evaluates or executes itself is dispatched without a virtual call.
+  auto evaluate(const expression::Expr &expr) const -> eval_result_t {
+    return const_cast<interpreter *>(this)->evaluate4(expr);
+  }
+  auto execute(const statement::Stmt &stmt) const -> exec_result_t {
+    return const_cast<interpreter *>(this)->execute4(stmt);
+  }
+
+public:
+  eval_result_t interpret(std::span<statement::Stmt *const>);
+  /// @brief run top-level statements one at a time, each resolved and passed
+  /// to @ref interpret_next as soon as it is parsed, instead of all at once.
+  auto stream() -> interpreter &;
+  /// @brief run the next top-level statement, after those before it.
+  eval_result_t interpret_next(const statement::Stmt &);
+  /// @brief done with the statement last run; unless @p keep, its nodes are
+  /// about to be freed, so what was resolved for them is forgotten.
+  void retire(bool keep);
+  /// @brief drop the values printed so far, once @ref to_string wrote them.
+  void clear_output() noexcept { stmts_res.clear(); }
+  /// @brief evaluate a lone expression, keeping its value for @ref to_string.
+  eval_result_t evaluate_expression(const expression::Expr &);
   auto set_env(const env_ptr_t &) -> interpreter &;
   auto get_current_env() { return env; }
-  size_t resolve(const std::shared_ptr<const expression::Expr> &, size_t);
+  auto set_upvalues(const upvalues_t *) -> interpreter &;
+  auto get_current_upvalues() const { return upvalues; }
+  auto get_symbols() const -> const SymbolTable & { return *symbols; }
+  auto get_cache_stats() const noexcept -> const cache_stats_t & {
+    return cache_stats;
+  }
+  auto resolve(const expression::Expr &, const location_t &) -> location_t &;
+  auto resolve(const statement::Stmt &, const location_t &) -> location_t &;
+  /// @brief bindings that have no node of their own: the receiver of a `super`
+  /// call(its method token) and the `super` of a class(its superclass token).
+  auto resolve(const Token &, const location_t &) -> location_t &;
+  void resolve_global(const expression::Expr &, symbol_id_t);
+  void resolve_global(const statement::Stmt &, symbol_id_t);
+  void resolve_frame(const statement::Function &, frame_t &&);
+  /// @brief the frame of the top-level code, holding the locals of its blocks.
+  void resolve_script_frame(size_t);
+  /// @brief enter a frame of @p size slots whose parameters are @p args, as
+  /// @ref push_args left them, preceded by the receiver slot if it has one.
+  /// @return the base of the enclosing frame, for @ref pop_frame.
+  auto push_frame(size_t, evaluation::Callable::args_t, bool) -> size_t;
+  void pop_frame(size_t);
+  auto frame_slot(size_t) -> variant_type &;
+  /// @brief move a slot of the current frame into a cell for closures to share.
+  auto capture_slot(size_t) -> upvalues_t::value_type;
+  /// @brief the value of the `return` that unwound to the function being
+  /// called.
+  auto take_return_value() -> variant_type {
+    return std::exchange(return_value, {});
+  }
 
 private:
   virtual auto visit2(const expression::Literal &) -> eval_result_t override;
@@ -124,30 +236,77 @@ private:
   evaluation::Boolean is_true_value(const eval_result_t &) const;
   evaluation::Boolean is_deep_equal(const eval_result_t &,
                                     const eval_result_t &) const;
-  auto get_call_args(const expression::Call &) const
-      -> auxilia::StatusOr<std::vector<variant_type>>;
+  /// @brief evaluate the arguments of a call onto the top of the stack, after
+  /// a slot reserved for the receiver of a method, and check there are
+  /// @p arity of them; @ref pop_args drops them.
+  auto push_args(const expression::Call &, unsigned arity)
+      -> auxilia::StatusOr<evaluation::Callable::args_t>;
+  void pop_args(size_t);
+  /// @brief the entry of the property cache for the instance's shape, filled
+  /// in on a miss; nullptr if a Get finds neither a field nor a method.
+  auto lookup_property(expression::PropertyCache &,
+                       const evaluation::Instance &,
+                       const Token &,
+                       bool) -> const expression::PropertyCache::entry_t *;
+  /// @return the cache entry of the property a Get reads from the object, or
+  /// the error if it's not an instance or has no such property.
+  auto find_property(const expression::Get &, const variant_type &)
+      -> auxilia::StatusOr<const expression::PropertyCache::entry_t *>;
   auto get_function(const statement::Function &, bool = false)
       -> evaluation::Function;
-  auto find_variable(const cexpr_ptr_t &, const Token &) -> eval_result_t;
+  auto find_variable(const expression::Expr &, const Token &) -> eval_result_t;
+  auto lookup(const location_t &) const -> variant_type *;
+  void declare_variable(const statement::Stmt &);
+  void declare_at(const location_t &);
+  void define_at(const location_t &, symbol_id_t, const variant_type &);
+  auto global_slot(symbol_id_t) -> size_t;
+  void bind_globals();
+  auto define_variable(const statement::Stmt &,
+                       const Token &,
+                       const variant_type &) -> auxilia::Status;
 
 private:
-  virtual auto visit2(const statement::Variable &) -> eval_result_t override;
-  virtual auto visit2(const statement::Print &) -> eval_result_t override;
-  virtual auto visit2(const statement::Expression &) -> eval_result_t override;
-  virtual auto visit2(const statement::Block &) -> eval_result_t override;
-  virtual auto visit2(const statement::If &) -> eval_result_t override;
-  virtual auto visit2(const statement::While &) -> eval_result_t override;
-  virtual auto visit2(const statement::For &) -> eval_result_t override;
-  virtual auto visit2(const statement::Function &) -> eval_result_t override;
-  virtual auto visit2(const statement::Class &) -> eval_result_t override;
-  virtual auto visit2(const statement::Return &) -> eval_result_t override;
-  virtual auto execute4(const statement::Stmt &) -> eval_result_t override;
+  virtual auto visit2(const statement::Variable &) -> exec_result_t override;
+  virtual auto visit2(const statement::Print &) -> exec_result_t override;
+  virtual auto visit2(const statement::Expression &) -> exec_result_t override;
+  virtual auto visit2(const statement::Block &) -> exec_result_t override;
+  virtual auto visit2(const statement::If &) -> exec_result_t override;
+  virtual auto visit2(const statement::While &) -> exec_result_t override;
+  virtual auto visit2(const statement::For &) -> exec_result_t override;
+  virtual auto visit2(const statement::Function &) -> exec_result_t override;
+  virtual auto visit2(const statement::Class &) -> exec_result_t override;
+  virtual auto visit2(const statement::Return &) -> exec_result_t override;
+  virtual auto execute4(const statement::Stmt &) -> exec_result_t override;
 
 private:
-  eval_result_t last_expr_res{auxilia::Monostate{}};
+  /// @brief the value of the expression @ref evaluate_expression evaluated;
+  /// results of the nodes within are only returned.
+  eval_result_t expression_result{auxilia::Monostate{}};
   std::vector<eval_result_t> stmts_res{};
   env_ptr_t env{};
+  /// @brief the global environment; its slots are the dense global table.
+  env_ptr_t globals{};
   local_env_t local_env{};
+  std::unordered_map<const statement::Function *, frame_t> frames{};
+  /// @brief the frames of the functions being executed, one after another,
+  /// on top of the frame of the top-level code.
+  std::vector<variant_type> stack{};
+  /// @brief the cells of the captured locals, parallel to @ref stack.
+  upvalues_t stack_cells{};
+  size_t frame_base = 0;
+  size_t script_frame_size = 0;
+  size_t call_depth = 0;
+  variant_type return_value{};
+  cache_stats_t cache_stats{};
+  /// @brief the upvalues of the function being executed, if any.
+  const upvalues_t *upvalues = nullptr;
+  /// @brief index of each global name in @ref globals, assigned by the
+  /// Resolver at its first declaration or reference.
+  std::unordered_map<symbol_id_t, size_t> global_slots{};
+  /// @brief the global slots assigned since @ref bind_globals last ran.
+  std::vector<std::pair<symbol_id_t, size_t>> unbound_globals{};
+  /// @brief names interned by the lexer of the program being run.
+  std::shared_ptr<SymbolTable> symbols;
   // temporary fix, is it's true, do not `to_string` for last_expr.
   bool is_interpreting_stmts = false;
 
@@ -161,20 +320,15 @@ public:
                      auxilia::FormatPolicy::kDefault) const -> string_type;
 
 private:
-  [[nodiscard]] inline interpreter::eval_result_t
-  Returning(interpreter::eval_result_t &&res) {
-    this->last_expr_res.reset(*res).ignore_error();
-    return {auxilia::Status::kReturning, *res};
-  }
-  [[nodiscard]] inline interpreter::eval_result_t
-  Returning(interpreter::eval_result_t &res) {
-    this->last_expr_res.reset(*res).ignore_error();
-    return {auxilia::Status::kReturning, *res};
+  /// @brief statements only pass a status up to the function being called,
+  /// so the returned value waits in @ref return_value.
+  [[nodiscard]] inline interpreter::exec_result_t
+  Returning(variant_type &&value) {
+    return_value = std::move(value);
+    return Completion::Return();
   }
 
 private:
   friend AC_LOX_API void delete_interpreter_fwd(interpreter *);
-  /// @brief basic RAII guard for entering a new scope.
-  struct environment_guard;
 };
 } // namespace accat::lox
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <source_location>
 #include <string>
 #include <string_view>
@@ -11,6 +12,7 @@
 
 #include "details/lox_fwd.hpp"
 #include "details/lex_error.hpp"
+#include "SymbolTable.hpp"
 #include "Token.hpp"
 
 /// @namespace accat::lox
@@ -24,8 +26,9 @@ public:
   using status_t = auxilia::Status;
   using token_t = Token;
   using token_type_t = token_t::token_type;
-  using tokens_t = std::vector<token_t>;
-  using lexeme_views_t = std::vector<string_view_type>;
+  using compact_token_t = CompactToken;
+  using tokens_t = std::vector<compact_token_t>;
+  using newlines_t = std::vector<uint32_t>;
   using char_t = typename string_type::value_type;
   using error_t = lex_error;
   using error_code_t = typename error_t::type_t;
@@ -49,7 +52,21 @@ public:
   /// @brief lex the contents of the file
   /// @return OkStatus() if successful, NotFoundError() otherwise
   status_t lex();
+  /// @brief lex just the next token and hand it over rather than keep it, for a
+  /// parser pulling tokens as it goes; EOF once the contents run out.
+  /// @note not to be mixed with @ref lex. the contents, the line breaks and the
+  /// interned strings are kept all the same, so this saves the token vector
+  /// but not memory proportional to the source.
+  auto next() -> compact_token_t;
   auto get_tokens() -> tokens_t &;
+  /// @brief the full token a compact one stands for; its lexeme is a view into
+  /// the contents, valid as long as the lexer is.
+  auto materialize(const compact_token_t &) const -> token_t;
+  /// @return the line of the source the character at @p offset is on.
+  auto line_of(size_type offset) const noexcept -> uint_least32_t;
+  /// @brief the table identifiers were interned into; share it with the
+  /// interpreter running these tokens.
+  auto get_symbols() const -> std::shared_ptr<SymbolTable> { return symbols; }
   bool ok() const noexcept;
   uint_least32_t error() const noexcept;
 
@@ -59,7 +76,7 @@ private:
   void add_string();
   void add_comment();
   void next_token();
-  void add_token(const token_type_t &, literal_type = {});
+  void add_token(const token_type_t &, error_code_t = error_t::kMonostate);
   void add_lex_error(lex_error::type_t = error_t::kMonostate);
   bool is_at_end(size_t = 0) const;
   auto lex_string() -> lexer::status_t::Code;
@@ -98,14 +115,17 @@ private:
   size_type cursor = 0;
   /// @brief the contents of the file
   const string_type contents = string_type();
-  /// @brief lexme views(non-owning)
-  lexeme_views_t lexeme_views = lexeme_views_t();
-  /// @brief current source line number
-  uint_least32_t current_line = 1;
+  /// @brief offsets of the line breaks met so far, in order; a token's line is
+  /// looked up here rather than stored in it.
+  newlines_t newlines = newlines_t();
+  /// @brief the line breaks before the offset @ref line_of was last asked for
+  mutable newlines_t::size_type line_hint = 0;
   /// @brief tokens
   tokens_t tokens = tokens_t();
   /// @brief errors
   uint_least32_t error_count = 0;
+  /// @brief interned identifiers
+  std::shared_ptr<SymbolTable> symbols = std::make_shared<SymbolTable>();
 
 private:
   friend AC_LOX_API void delete_lexer_fwd(lexer *);
@@ -13,6 +13,7 @@
 
 #include "details/lox_fwd.hpp"
 
+#include "Arena.hpp"
 #include "parse_error.hpp"
 #include "Token.hpp"
 
@@ -26,27 +27,40 @@ public:
 
 public:
   using token_t = Token;
-  using token_views_t = std::span<token_t>;
+  using compact_token_t = CompactToken;
+  using token_views_t = std::span<const compact_token_t>;
   using token_type_t = token_t::token_type;
   using string_type = std::string;
   using string_view_type = std::string_view;
   using size_type = token_views_t::size_type;
   using ssize_type = decltype(std::ssize(std::declval<token_views_t>()));
   using expr_t = expression::Expr;
-  using expr_ptr_t = std::shared_ptr<expr_t>;
+  using expr_ptr_t = expr_t *;
   using stmt_t = statement::Stmt;
-  using stmt_ptr_t = std::shared_ptr<stmt_t>;
+  using stmt_ptr_t = stmt_t *;
   using stmt_ptrs_t = std::vector<stmt_ptr_t>;
   using enum token_type_t::type_t;
 
 public:
   parser() = default;
-  parser &set_views(token_views_t = {});
+  /// @brief parse the tokens of @p source, which must outlive the parser: the
+  /// nodes' tokens view its contents.
+  parser &set_views(const lexer &source);
+  /// @brief pull the tokens of @p source from it as they are needed instead,
+  /// through a small window, to parse one statement at a time with
+  /// @ref parse_next.
+  parser &set_stream(lexer &source);
   /// @brief main entry point for parsing.
-  /// @note Expression needs to be shared; especially for variables.
-  ///  `(a + b) * (a + b)`. `(a + b)` is shared. `std::unique_ptr` may
-  /// bring redundancy.
+  /// @note the nodes belong to the parser's @ref Arena: the statements and the
+  /// expression are valid as long as the parser is.
   auto parse(const ParsePolicy &) -> auxilia::Status;
+  /// @brief parse the next top-level statement of the stream.
+  /// @return the statement, or nullptr past the last one.
+  /// @note the nodes of the statement before are freed first, unless it
+  /// declared a function or a class, which live on as values.
+  auto parse_next() -> auxilia::StatusOr<stmt_ptr_t>;
+  /// @return whether the last statement @ref parse_next returned is kept.
+  auto keeps_last() const noexcept -> bool { return keeps_statement; }
   auto get_statements() const -> stmt_ptrs_t &;
   auto get_expression() const -> expr_ptr_t &;
 
@@ -99,6 +113,10 @@ private:
   bool inspect(Args &&...);
   /// @brief check if the current token is at(or past) the end of the token
   bool is_at_end(size_type = 0) const;
+  /// @brief in streaming mode, refill the window from the lexer once the
+  /// cursor nears its end, keeping the token before the cursor.
+  void pull();
+  /// @brief materialize the current token and advance the cursor
   auto get(size_type = 1) -> token_t;
   /// @brief get the current token(or the token at the offset) without advancing
   /// the cursor
@@ -113,8 +131,19 @@ private:
   }
 
 private:
+  static constexpr size_type kWindowSize = 64;
+  Arena arena;
+  const lexer *source = nullptr;
   token_views_t tokens = {};
   token_views_t::iterator cursor{};
+  /// @brief the lexer tokens are pulled from, in streaming mode.
+  lexer *stream = nullptr;
+  /// @brief the tokens pulled and not yet passed, in streaming mode.
+  std::vector<compact_token_t> window = {};
+  /// @brief where the arena was before the last statement @ref parse_next made.
+  Arena::mark_t statement_mark = {};
+  /// @brief whether the statement being parsed declares a function or a class.
+  bool keeps_statement = false;
   mutable expr_ptr_t expr_head = nullptr;
   mutable stmt_ptrs_t stmts = {};
   // bool is_in_panic = false;
@@ -6,43 +6,55 @@
 
 #include "details/lox_fwd.hpp"
 
+#include "details/Completion.hpp"
+
 #include "Token.hpp"
 
 namespace accat::lox::statement {
-class Stmt : public auxilia::Printable,
-             public std::enable_shared_from_this<Stmt> {
+/// @note nodes live in the @ref Arena of the program they were parsed from.
+class Stmt : public auxilia::Printable {
 public:
   using base_type = Stmt;
   using string_type = std::string;
   using ostream_t = std::ostream;
   using ostringstream_t = std::ostringstream;
   using token_t = Token;
-  using stmt_ptr_t = std::shared_ptr<base_type>;
-  using expr_ptr_t = std::shared_ptr<expression::Expr>;
-  using stmt_result_t = auxilia::Status;
+  using stmt_ptr_t = base_type *;
+  using expr_ptr_t = expression::Expr *;
+  using stmt_result_t = Completion;
+
+public:
+  /// @brief the concrete type of the node, which visitors switch on.
+  enum class Kind : std::uint8_t {
+    kVariable,
+    kPrint,
+    kExpression,
+    kBlock,
+    kIf,
+    kWhile,
+    kFor,
+    kFunction,
+    kClass,
+    kReturn,
+  };
+  const Kind kind;
+
+protected:
+  constexpr explicit Stmt(const Kind kind) noexcept : kind(kind) {}
 
 public:
   virtual ~Stmt() = default;
 
-public:
-  template <typename DerivedVisitor>
-    requires std::is_base_of_v<StmtVisitor, DerivedVisitor>
-  auto accept(const DerivedVisitor &visitor) const {
-    return accept2(visitor);
-  }
-
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type = 0;
-
-private:
-  virtual stmt_result_t accept2(const StmtVisitor &) const = 0;
 };
 class Variable : public Stmt {
 public:
-  Variable() = default;
+  Variable() : Stmt(Kind::kVariable) {}
   Variable(token_t &&name, expr_ptr_t &&initializer)
-      : name(std::move(name)), initializer(std::move(initializer)) {}
+      : Stmt(Kind::kVariable), name(std::move(name)),
+        initializer(std::move(initializer)) {}
   virtual ~Variable() override = default;
 
 public:
@@ -52,10 +64,7 @@ public:
 
 public:
   token_t name;
-  expr_ptr_t initializer;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
+  expr_ptr_t initializer = nullptr;
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
@@ -63,42 +72,38 @@ public:
 };
 class Print : public Stmt {
 public:
-  constexpr Print() = default;
-  explicit Print(expr_ptr_t &&value) : value(std::move(value)) {}
+  constexpr Print() : Stmt(Kind::kPrint) {}
+  explicit Print(expr_ptr_t &&value)
+      : Stmt(Kind::kPrint), value(std::move(value)) {}
   virtual ~Print() override = default;
 
 public:
-  expr_ptr_t value;
+  expr_ptr_t value = nullptr;
 
 private:
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 class Expression : public Stmt {
 public:
-  constexpr Expression() = default;
-  explicit Expression(expr_ptr_t &&expr) : expr(std::move(expr)) {}
+  constexpr Expression() : Stmt(Kind::kExpression) {}
+  explicit Expression(expr_ptr_t &&expr)
+      : Stmt(Kind::kExpression), expr(std::move(expr)) {}
   virtual ~Expression() override = default;
 
 public:
-  expr_ptr_t expr;
+  expr_ptr_t expr = nullptr;
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 class Block : public Stmt {
 public:
-  constexpr Block() = default;
+  constexpr Block() : Stmt(Kind::kBlock) {}
   explicit Block(std::vector<stmt_ptr_t> &&statements)
-      : statements(std::move(statements)) {}
+      : Stmt(Kind::kBlock), statements(std::move(statements)) {}
   virtual ~Block() override = default;
 
 public:
@@ -107,104 +112,93 @@ public:
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 
 class If : public Stmt {
 public:
-  constexpr If() = default;
+  constexpr If() : Stmt(Kind::kIf) {}
   explicit If(expr_ptr_t &&condition,
               stmt_ptr_t &&then_branch,
               stmt_ptr_t &&else_branch)
-      : condition(std::move(condition)), then_branch(std::move(then_branch)),
+      : Stmt(Kind::kIf), condition(std::move(condition)),
+        then_branch(std::move(then_branch)),
         else_branch(std::move(else_branch)) {}
   virtual ~If() = default;
 
 public:
-  expr_ptr_t condition;
-  stmt_ptr_t then_branch;
-  stmt_ptr_t else_branch; // needed to set to nullptr
+  expr_ptr_t condition = nullptr;
+  stmt_ptr_t then_branch = nullptr;
+  stmt_ptr_t else_branch = nullptr; // needed to set to nullptr
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 
 class While : public Stmt {
 public:
-  constexpr While() = default;
+  constexpr While() : Stmt(Kind::kWhile) {}
   explicit While(expr_ptr_t &&condition, stmt_ptr_t &&body)
-      : condition(std::move(condition)), body(std::move(body)) {}
+      : Stmt(Kind::kWhile), condition(std::move(condition)),
+        body(std::move(body)) {}
   virtual ~While() = default;
 
 public:
-  expr_ptr_t condition;
-  stmt_ptr_t body;
+  expr_ptr_t condition = nullptr;
+  stmt_ptr_t body = nullptr;
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 
 /// @todo: This ought to be desugared to `while` statement in parser.
 class For : public Stmt {
 public:
-  constexpr For() = default;
+  constexpr For() : Stmt(Kind::kFor) {}
   explicit For(stmt_ptr_t &&initializer,
                expr_ptr_t &&condition,
                expr_ptr_t &&increment,
                stmt_ptr_t &&body)
-      : initializer(std::move(initializer)), condition(std::move(condition)),
+      : Stmt(Kind::kFor), initializer(std::move(initializer)),
+        condition(std::move(condition)),
         increment(std::move(increment)), body(std::move(body)) {}
   virtual ~For() = default;
 
 public:
-  stmt_ptr_t initializer;
-  expr_ptr_t condition;
-  expr_ptr_t increment;
-  stmt_ptr_t body;
+  stmt_ptr_t initializer = nullptr;
+  expr_ptr_t condition = nullptr;
+  expr_ptr_t increment = nullptr;
+  stmt_ptr_t body = nullptr;
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 
 class Return : public Stmt {
 public:
-  constexpr Return() = default;
+  constexpr Return() : Stmt(Kind::kReturn) {}
   explicit Return(expr_ptr_t &&value, uint_least32_t line)
-      : value(std::move(value)), line(line) {}
+      : Stmt(Kind::kReturn), value(std::move(value)), line(line) {}
   virtual ~Return() = default;
 
 public:
-  expr_ptr_t value;
+  expr_ptr_t value = nullptr;
   uint_least32_t line = std::numeric_limits<uint_least32_t>::max();
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 class Function : public Stmt {
 public:
-  constexpr Function() = default;
+  constexpr Function() : Stmt(Kind::kFunction) {}
   explicit Function(token_t &&name,
                     std::vector<token_t> &&parameters,
                     std::vector<stmt_ptr_t> &&body)
-      : name(std::move(name)), parameters(std::move(parameters)),
+      : Stmt(Kind::kFunction), name(std::move(name)),
+        parameters(std::move(parameters)),
         body(std::move(body)) {}
   virtual ~Function() = default;
 
@@ -216,30 +210,24 @@ public:
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 class Class : public Stmt {
 public:
   token_t name;
   std::vector<Function> methods;
-  std::shared_ptr<expression::Variable> superclass;
+  expression::Variable *superclass = nullptr;
 
 public:
-  constexpr Class() = default;
+  constexpr Class() : Stmt(Kind::kClass) {}
   explicit Class(token_t &&name,
-                 std::shared_ptr<expression::Variable> &&superclass,
+                 expression::Variable *superclass,
                  std::vector<Function> &&methods)
-      : name(std::move(name)), superclass(std::move(superclass)),
+      : Stmt(Kind::kClass), name(std::move(name)), superclass(superclass),
         methods(std::move(methods)) {}
   virtual ~Class() = default;
 
 public:
   virtual auto to_string(const auxilia::FormatPolicy &) const
       -> string_type override;
-
-private:
-  auto accept2(const StmtVisitor &) const -> stmt_result_t override;
 };
 } // namespace accat::lox::statement
@@ -19,7 +19,7 @@ using auxilia::FormatPolicy;
 using enum auxilia::FormatPolicy;
 
 auto ASTPrinter::evaluate4(const Expr &expr) -> eval_result_t {
-  return res = expr.accept(*this);
+  return res = this->dispatch(expr);
 }
 auto ASTPrinter::visit2(const Literal &expr) -> eval_result_t {
   dbg(trace, "Literal: {}", expr.to_string(kDefault))
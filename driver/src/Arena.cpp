@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+#include "Arena.hpp"
+
+namespace accat::lox {
+Arena::~Arena() noexcept {
+  // a node is made after its children, so it goes before them.
+  for (const auto &[object, destroy] : destructors | std::views::reverse)
+    destroy(object);
+}
+void Arena::rewind(const mark_t &mark) noexcept {
+  for (auto i = destructors.size(); i-- > mark.destructors;)
+    destructors[i].second(destructors[i].first);
+  destructors.resize(mark.destructors);
+  blocks.resize(mark.blocks);
+  cursor = mark.cursor;
+  end = mark.end;
+  used = mark.used;
+}
+auto Arena::allocate(const size_t size, const size_t alignment) -> void * {
+  auto space = static_cast<size_t>(end - cursor);
+  auto ptr = static_cast<void *>(cursor);
+  if (!cursor || !std::align(alignment, size, ptr, space)) {
+    // an oversized node gets a block of its own.
+    const auto block_size = std::max(kBlockSize, size + alignment);
+    blocks.emplace_back(
+        std::make_unique_for_overwrite<std::byte[]>(block_size));
+    cursor = blocks.back().get();
+    end = cursor + block_size;
+    space = block_size;
+    ptr = cursor;
+    std::align(alignment, size, ptr, space);
+  }
+  cursor = static_cast<std::byte *>(ptr) + size;
+  used += size;
+  return ptr;
+}
+} // namespace accat::lox
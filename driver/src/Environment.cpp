@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -13,6 +14,7 @@
 #include "details/lox_fwd.hpp"
 #include "Environment.hpp"
 #include "Evaluatable.hpp"
+#include "SymbolTable.hpp"
 
 namespace accat::lox {
 using auxilia::Status;
@@ -28,6 +30,8 @@ Env::Environment(const std::shared_ptr<self_type> &enclosing)
 
 Env::Environment(Environment &&that) noexcept {
   current = std::move(that.current);
+  slots = std::move(that.slots);
+  slot_names = std::move(that.slot_names);
   parent = std::move(that.parent);
 }
 
@@ -36,6 +40,8 @@ auto Env::operator=(Env &&that) noexcept -> Env & {
     return *this;
   }
   this->current = std::move(that.current);
+  this->slots = std::move(that.slots);
+  this->slot_names = std::move(that.slot_names);
   this->parent = std::move(that.parent);
   return *this;
 }
@@ -43,21 +49,20 @@ auto Env::initGlobalEnv() -> std::shared_ptr<Env> {
   isGlobalScopeInited = true;
   global_env = std::make_shared<Env>();
   global_env
-      ->add("clock"s,
+      ->add(SymbolTable::kClock,
             evaluation::Function::create_native(
                 0,
                 [](interpreter &,
                    evaluation::Function::args_t &) -> variant_type {
                   dbg(trace, "clock() called")
-                  return {evaluation::Number{static_cast<long double>(
+                  return {evaluation::Number{static_cast<double>(
                       std::chrono::duration_cast<std::chrono::seconds>(
                           std::chrono::system_clock::now().time_since_epoch())
                           .count())}};
-                },
-                nullptr))
+                }))
       .ignore_error();
   global_env
-      ->add("about",
+      ->add(SymbolTable::kAbout,
             evaluation::Function::create_native(
                 0,
                 [](interpreter &,
@@ -65,8 +70,7 @@ auto Env::initGlobalEnv() -> std::shared_ptr<Env> {
                   return {
                       evaluation::String{"lox programming language, based on "
                                          "book Crafting Interpreters."sv}};
-                },
-                nullptr))
+                }))
       .ignore_error();
   return global_env;
 }
@@ -81,13 +85,13 @@ auto Env::Scope(const std::shared_ptr<self_type> &enclosing)
   return std::shared_ptr<Env>(new Env(enclosing));
 }
 
-auto Env::add(const string_view_type name,
+auto Env::add(const symbol_type name,
               const variant_type &value,
               const uint_least32_t line) -> Status {
   return current.add(name, value, line);
 }
 
-auto Env::reassign(const string_view_type name,
+auto Env::reassign(const symbol_type name,
                    const variant_type &value,
                    const uint_least32_t line,
                    bool currentScopeOnly) -> Status {
@@ -99,42 +103,59 @@ auto Env::reassign(const string_view_type name,
   return auxilia::InvalidArgumentError("variable not defined");
 }
 
-auto Env::get(const string_view_type name, const bool currentScopeOnly) const
+auto Env::get(const symbol_type name, const bool currentScopeOnly) const
     -> variant_type* {
-  if (auto it = const_cast<Env *>(this)->find(name, currentScopeOnly))
+  if (auto it = const_cast<Env *>(this)->find(name, true))
     return &(*it)->second.first;
 
+  if (const auto it = std::ranges::find(slot_names, name);
+      it != slot_names.end())
+    return const_cast<variant_type *>(
+        &slots[std::ranges::distance(slot_names.begin(), it)]);
+
+  if (!currentScopeOnly)
+    if (const auto enclosing = parent.get())
+      return enclosing->get(name, currentScopeOnly);
+
   return nullptr;
 }
 
-auto Env::ancestor(const size_t n) const -> std::shared_ptr<self_type> {
+auto Env::ancestor_raw(const size_t n) const -> self_type * {
   auto raw_env = const_cast<Env *>(this);
   for (auto _ : std::views::iota(0ull, n)) {
-    if (!raw_env or !raw_env->parent)
+    if (!raw_env)
       return nullptr;
     raw_env = raw_env->parent.get();
   }
-  return raw_env->shared_from_this();
+  return raw_env;
 }
-auto Env::get_at_depth(const size_t n, const string_view_type name) const
-    -> variant_type* {
-  auto myenv = this->ancestor(n);
-  contract_assert(myenv, "ancestor is null")
-  const auto it = myenv->find(name, true);
-  contract_assert(it, "variable not found")
-  return &(*it)->second.first;
+auto Env::ancestor(const size_t n) const -> std::shared_ptr<self_type> {
+  auto raw_env = ancestor_raw(n);
+  return raw_env ? raw_env->shared_from_this() : nullptr;
+}
+auto Env::define_at(const size_t slot,
+                    const symbol_type name,
+                    const variant_type &value) -> void {
+  if (slot >= slots.size()) {
+    slots.resize(slot + 1);
+    slot_names.resize(slot + 1);
+  }
+  slots[slot] = value;
+  slot_names[slot] = name;
 }
-auto Env::reassign_at_depth(const size_t n,
-                            const string_view_type name,
-                            const variant_type &value,
-                            const uint_least32_t line) -> Status {
-  precondition(this->ancestor(n), "ancestor is null")
-  return this->ancestor(n)->reassign(name, value, line, true);
+auto Env::find_at(const size_t slot) const -> variant_type * {
+  if (slot >= slots.size() || slots[slot].empty())
+    return nullptr;
+  return const_cast<variant_type *>(&slots[slot]);
 }
 
 auto Env::to_string(const FormatPolicy &format_policy) const -> string_type {
   std::ostringstream oss;
-  oss << current.to_string(format_policy) << ",\n\t-> ";
+  oss << current.to_string(format_policy);
+  for (size_t i = 0; i < slots.size(); ++i)
+    oss << auxilia::format(
+        " [{}] #{}: {},", i, slot_names[i], slots[i].to_string(format_policy));
+  oss << ",\n\t-> ";
   if (const auto enclosing = this->parent.get())
     oss << enclosing->to_string(format_policy);
   else
@@ -142,7 +163,7 @@ auto Env::to_string(const FormatPolicy &format_policy) const -> string_type {
   return oss.str();
 }
 
-auto Env::find(const string_view_type name, const bool currentScopeOnly) const
+auto Env::find(const symbol_type name, const bool currentScopeOnly) const
     -> std::optional<self_type::scope_env_t::associations_t::const_iterator> {
   if (auto maybe_it = current.find(name)) {
     dbg_block
@@ -166,7 +187,7 @@ auto Env::find(const string_view_type name, const bool currentScopeOnly) const
 
   return std::nullopt;
 }
-auto Env::find(const string_view_type name, const bool currentScopeOnly)
+auto Env::find(const symbol_type name, const bool currentScopeOnly)
     -> std::optional<self_type::scope_env_t::associations_t::iterator> {
   if (auto maybe_it = current.find(name)) {
     dbg_block
@@ -190,7 +211,7 @@ auto Env::find(const string_view_type name, const bool currentScopeOnly)
 
   return std::nullopt;
 }
-auto Environment::find_symbol(const string_view_type name,
+auto Environment::find_symbol(const symbol_type name,
                               const bool currentScopeOnly) const
     -> std::optional<self_type::scope_env_t::associations_t::const_iterator> {
   if (auto maybe_it = current.find_symbol(name)) {
@@ -216,7 +237,7 @@ auto Environment::find_symbol(const string_view_type name,
   return std::nullopt;
 }
 
-auto Env::find_symbol(const string_view_type name,
+auto Env::find_symbol(const symbol_type name,
                       const bool currentScopeOnly) -> std::optional<self_type::scope_env_t::associations_t::iterator> {
   if (auto maybe_it = current.find_symbol(name)) {
     dbg_block
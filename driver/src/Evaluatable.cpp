@@ -3,12 +3,14 @@
 #include <memory>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "details/IVisitor.hpp"
 #include "details/lox_fwd.hpp"
 
 #include "Evaluatable.hpp"
 #include "Environment.hpp"
+#include "SymbolTable.hpp"
 #include "interpreter.hpp"
 #include <accat/auxilia/auxilia.hpp>
 
@@ -19,12 +21,12 @@ using auxilia::match;
 
 Value::operator Boolean() const noexcept {
   if (dynamic_cast<const Nil *>(this)) {
-    return Boolean::make_false(get_line());
+    return False;
   }
   if (const auto ptr = dynamic_cast<const Boolean *>(this)) {
     return *ptr;
   }
-  return Boolean::make_true(get_line());
+  return True;
 }
 
 Boolean Value::operator!() const noexcept {
@@ -32,7 +34,7 @@ Boolean Value::operator!() const noexcept {
 }
 
 Boolean::Boolean(const Boolean &value)
-    : Value(value.get_line()), value(value.value) {}
+    : value(value.value) {}
 
 Boolean &Boolean::operator=(const Boolean &value) {
   this->value = value.value;
@@ -41,7 +43,7 @@ Boolean &Boolean::operator=(const Boolean &value) {
 }
 
 Boolean::Boolean(Boolean &&value) noexcept
-    : Value(value.get_line()), value(value.value) {}
+    : value(value.value) {}
 
 Boolean &Boolean::operator=(Boolean &&value) noexcept {
   this->value = value.value;
@@ -49,14 +51,6 @@ Boolean &Boolean::operator=(Boolean &&value) noexcept {
   return *this;
 }
 
-auto Boolean::make_true(const uint_least32_t line) -> Boolean {
-  return Boolean{true, line};
-}
-
-auto Boolean::make_false(const uint_least32_t line) -> Boolean {
-  return Boolean{false, line};
-}
-
 bool Boolean::is_true() const noexcept { return value; }
 
 auto Boolean::to_string(const auxilia::FormatPolicy &format_policy) const
@@ -93,64 +87,173 @@ auto Nil::to_string_view(const auxilia::FormatPolicy &format_policy) const
   return "nil"sv;
 }
 
-String::String(const string_type &value, const uint_least32_t line)
-    : Evaluatable(line), value(value) {}
+/// @brief a flat buffer, or the concatenation of two ropes until it's read.
+struct String::Rope {
+  mutable string_type flat;
+  mutable rope_ptr_t left;
+  mutable rope_ptr_t right;
+  size_t size;
+
+  explicit Rope(string_type &&flat)
+      : flat(std::move(flat)), size(this->flat.size()) {}
+  Rope(rope_ptr_t left, rope_ptr_t right)
+      : left(std::move(left)), right(std::move(right)),
+        size(this->left->size + this->right->size) {}
+  ~Rope();
+
+  auto view() const -> string_view_type;
+};
+String::Rope::~Rope() {
+  if (!left)
+    return;
+  // a string built in a loop is a chain as long as the loop; destroying it
+  // recursively could overflow the stack.
+  std::vector<rope_ptr_t> pending;
+  pending.emplace_back(std::move(left));
+  pending.emplace_back(std::move(right));
+  while (!pending.empty()) {
+    auto rope = std::move(pending.back());
+    pending.pop_back();
+    if (rope.use_count() == 1 && rope->left) {
+      pending.emplace_back(std::move(rope->left));
+      pending.emplace_back(std::move(rope->right));
+    }
+  }
+}
+auto String::Rope::view() const -> string_view_type {
+  if (!left)
+    return flat;
+
+  string_type buffer;
+  buffer.reserve(size);
+  std::vector<const Rope *> pending{right.get(), left.get()};
+  while (!pending.empty()) {
+    const auto rope = pending.back();
+    pending.pop_back();
+    if (rope->left) {
+      pending.push_back(rope->right.get());
+      pending.push_back(rope->left.get());
+    } else {
+      buffer += rope->flat;
+    }
+  }
+  flat = std::move(buffer);
+  left.reset();
+  right.reset();
+  return flat;
+}
 
-String::String(const string_view_type value, const uint_least32_t line)
-    : Evaluatable(line), value(value) {}
+String::String(const string_type &value) : String(string_view_type{value}) {}
 
-String::String(string_type &&value, const uint_least32_t line) noexcept
-    : Evaluatable(line), value(std::move(value)) {}
+String::String(const string_view_type value) {
+  if (value.size() > inline_size) {
+    rope = std::make_shared<const Rope>(string_type{value});
+    return;
+  }
+  inline_length = static_cast<std::uint8_t>(value.size());
+  std::ranges::copy(value, inline_chars.begin());
+}
 
-String::String(const String &that)
-    : Evaluatable(that.get_line()), value(that.value) {}
+String::String(string_type &&value) {
+  if (value.size() > inline_size) {
+    rope = std::make_shared<const Rope>(std::move(value));
+    return;
+  }
+  inline_length = static_cast<std::uint8_t>(value.size());
+  std::ranges::copy(value, inline_chars.begin());
+}
 
-String::String(String &&that) noexcept
-    : Evaluatable(that.get_line()), value(std::move(that.value)) {}
+String::String(const string_view_type value, const symbol_id_t symbol)
+    : String(value) {
+  this->symbol = symbol;
+}
 
-String &String::operator=(const String &that) {
-  if (this == &that)
-    return *this;
-  value = that.value;
-  Evaluatable::operator=(that);
-  return *this;
+String::String(rope_ptr_t rope) : rope(std::move(rope)) {}
+
+auto String::size() const noexcept -> size_t {
+  return rope ? rope->size : inline_length;
 }
 
-String &String::operator=(String &&that) noexcept {
-  if (this == &that)
-    return *this;
-  value = std::move(that.value);
-  Evaluatable::operator=(that);
-  return *this;
+auto String::hash() const -> size_t {
+  if (!cached_hash)
+    cached_hash = std::hash<string_view_type>{}(view());
+  return cached_hash;
+}
+
+auto String::view() const -> string_view_type {
+  return rope ? rope->view() : string_view_type{inline_chars.data(),
+                                                inline_length};
+}
+
+auto String::as_rope() const -> rope_ptr_t {
+  return rope ? rope : std::make_shared<const Rope>(string_type{view()});
 }
 
 String String::operator+(const String &rhs) const {
-  return String{value + rhs.value};
+  if (!rhs.size())
+    return *this;
+  if (!size())
+    return rhs;
+  if (size() + rhs.size() <= flat_size)
+    return String{string_type{view()}.append(rhs.view())};
+  return String{std::make_shared<const Rope>(as_rope(), rhs.as_rope())};
 }
 
 Boolean String::operator==(const String &rhs) const {
-  return {value == rhs.value};
+  if (symbol != SymbolTable::kInvalid && rhs.symbol != SymbolTable::kInvalid)
+    return {symbol == rhs.symbol};
+  if (size() != rhs.size())
+    return False;
+  if (rope && rope == rhs.rope)
+    return True;
+  if (cached_hash && rhs.cached_hash && cached_hash != rhs.cached_hash)
+    return False;
+  return {view() == rhs.view()};
 }
 
 Boolean String::operator!=(const String &rhs) const {
-  return {value != rhs.value};
+  return !(*this == rhs).is_true();
+}
+
+auto String::to_string(const auxilia::FormatPolicy &) const -> string_type {
+  return string_type{view()};
+}
+
+auto String::to_string_view(const auxilia::FormatPolicy &) const
+    -> string_view_type {
+  return view();
 }
 
 String::operator Boolean() const { return True; }
 
-Number::Number(const long double value, const uint_least32_t line)
-    : Value(line), value(value) {}
+namespace {
+auto is_exact_integer(const std::int64_t integer) noexcept {
+  return -Number::max_integer <= integer && integer <= Number::max_integer;
+}
+/// @brief the integral result of an operation on two integers, or the double
+/// it equals if it's out of range.
+auto make_integral(const std::int64_t integer) -> Number {
+  if (is_exact_integer(integer))
+    return {integer};
+  return {static_cast<double>(integer)};
+}
+} // namespace
+Number::Number(const double value) : value(value) {}
 
 Number::Number(const Number &that)
-    : Value(that.get_line()), value(that.value) {}
+    : Value(that), value(that.value), integer(that.integer),
+      integral(that.integral) {}
 
 Number::Number(Number &&that) noexcept
-    : Value(that.get_line()), value(that.value) {}
+    : Value(that), value(that.value), integer(that.integer),
+      integral(that.integral) {}
 
 Number &Number::operator=(const Number &that) {
   if (this == &that)
     return *this;
   value = that.value;
+  integer = that.integer;
+  integral = that.integral;
   Evaluatable::operator=(that);
   return *this;
 }
@@ -159,182 +262,178 @@ Number &Number::operator=(Number &&that) noexcept {
   if (this == &that)
     return *this;
   value = that.value;
+  integer = that.integer;
+  integral = that.integral;
   Evaluatable::operator=(that);
   return *this;
 }
 
+auto Number::from_double(const double value) -> Number {
+  // -0 is integral, but an integer can't keep its sign.
+  if (std::abs(value) <= static_cast<double>(max_integer) &&
+      std::trunc(value) == value && !std::signbit(value))
+    return {static_cast<std::int64_t>(value)};
+  return {value};
+}
+
 Boolean Number::operator==(const Number &that) const {
-  return {value == that.value};
+  if (integral && that.integral)
+    return {integer == that.integer};
+  return {get_value() == that.get_value()};
 }
 
 Boolean Number::operator!=(const Number &that) const {
-  return {value != that.value};
+  return !(*this == that).is_true();
 }
 
 Boolean Number::operator<(const Number &that) const {
-  return {value < that.value};
+  if (integral && that.integral)
+    return {integer < that.integer};
+  return {get_value() < that.get_value()};
 }
 
 Boolean Number::operator<=(const Number &that) const {
-  return {value <= that.value};
+  if (integral && that.integral)
+    return {integer <= that.integer};
+  return {get_value() <= that.get_value()};
 }
 
 Boolean Number::operator>(const Number &that) const {
-  return {value > that.value};
+  if (integral && that.integral)
+    return {integer > that.integer};
+  return {get_value() > that.get_value()};
 }
 
 Boolean Number::operator>=(const Number &that) const {
-  return {value >= that.value};
+  if (integral && that.integral)
+    return {integer >= that.integer};
+  return {get_value() >= that.get_value()};
 }
 
+// both operands are within +-2^53, so neither sum nor difference overflows.
 Number Number::operator-(const Number &that) const {
-  return {value - that.value};
+  if (integral && that.integral)
+    return make_integral(integer - that.integer);
+  return {get_value() - that.get_value()};
 }
 
 Number Number::operator+(const Number &that) const {
-  return {value + that.value};
+  if (integral && that.integral)
+    return make_integral(integer + that.integer);
+  return {get_value() + that.get_value()};
 }
 
 Number Number::operator*(const Number &that) const {
-  return {value * that.value};
+  const auto product = get_value() * that.get_value();
+  // the product of two integers is exact as long as it's in range; a zero
+  // product with a negative operand is -0.
+  if (integral && that.integral &&
+      std::abs(product) <= static_cast<double>(max_integer) &&
+      (product != 0 || (integer >= 0 && that.integer >= 0)))
+    return {static_cast<std::int64_t>(product)};
+  return {product};
 }
 
 Number Number::operator/(const Number &that) const {
-  return that.value == 0L
-             ? Number{std::numeric_limits<long double>::signaling_NaN()}
-             : Number{value / that.value};
+  if (that.get_value() == 0)
+    return Number{std::numeric_limits<double>::signaling_NaN()};
+  if (integral && that.integral && integer % that.integer == 0 &&
+      (integer != 0 || that.integer > 0))
+    return {integer / that.integer};
+  return Number{get_value() / that.get_value()};
 }
 
 Number &Number::operator+=(const Number &that) {
-  value += that.value;
-  return *this;
+  return *this = *this + that;
 }
 
 Number &Number::operator-=(const Number &that) {
-  value -= that.value;
-  return *this;
+  return *this = *this - that;
 }
 
 Number &Number::operator*=(const Number &that) {
-  value *= that.value;
-  return *this;
+  return *this = *this * that;
 }
 
 Number &Number::operator/=(const Number &that) {
-  value = that.value == 0L ? std::numeric_limits<long double>::signaling_NaN()
-                           : value / that.value;
-  return *this;
+  return *this = *this / that;
 }
 
 auto Number::to_string(const auxilia::FormatPolicy &format_policy) const
     -> string_type {
+  // below 2^53 an integer prints as the integral double would.
+  if (integral)
+    return auxilia::format("{}", integer);
   return auxilia::format("{}", value);
 }
 
-Function::Function(Function &&that) noexcept {
-  my_arity = that.my_arity;
-  my_function = std::move(that.my_function);
-  my_env = std::move(that.my_env);
-  is_initializer = that.is_initializer;
-}
-Function &Function::operator=(Function &&that) noexcept {
-  if (this == &that)
-    return *this;
-  this->my_arity = that.my_arity;
-  this->my_function = std::move(that.my_function);
-  this->my_env = std::move(that.my_env);
-  this->is_initializer = that.is_initializer;
-  return *this;
-}
-Function::Function(const unsigned argc,
-                   native_function_t &&func,
-                   const env_ptr_t &env,
-                   const bool is_initializer) {
-  my_arity = argc;
-  my_function.emplace(std::move(func));
-  my_env = env;
-  this->is_initializer = is_initializer;
-}
-
-Function::Function(const unsigned argc,
-                   custom_function_t &&block,
-                   const env_ptr_t &env,
-                   const bool is_initializer) {
-  my_arity = argc;
-  my_function.emplace(std::move(block));
-  my_env = env;
-  this->is_initializer = is_initializer;
-}
-Function::Function(const unsigned argc,
-                   const function_t &func,
-                   const env_ptr_t &env,
-                   const bool is_initializer) {
-  my_arity = argc;
-  my_function = func;
-  my_env = env;
-  this->is_initializer = is_initializer;
-}
+Function::Function(closure_ptr_t closure) : closure(std::move(closure)) {}
 
 auto Function::create_custom(unsigned argc,
                              custom_function_t &&func,
-                             const env_ptr_t &env,
+                             upvalues_t &&upvalues,
                              const bool is_initializer) -> Function {
-  return {argc, std::move(func), env, is_initializer};
+  return Function{std::make_shared<const Closure>(
+      argc, function_t{std::move(func)}, std::move(upvalues), is_initializer)};
 }
 
-auto Function::create_native(unsigned argc,
-                             native_function_t &&func,
-                             const env_ptr_t &env,
-                             const bool is_initializer) -> Function {
-  return {argc, std::move(func), env, is_initializer};
+auto Function::create_native(unsigned argc, native_function_t &&func)
+    -> Function {
+  return Function{
+      std::make_shared<const Closure>(argc, function_t{std::move(func)})};
 }
 auto Function::bind(const Instance &instance) const -> Function {
-  auto method_env = Environment::Scope(my_env);
-  // TODO: wrong here, copying an instance!!!
-  method_env->add("this", {instance});
-  return {my_arity, my_function, method_env, is_initializer};
+  auto method = Function{closure};
+  method.receiver = lox::Value::share(instance);
+  return method;
 }
 
-auto Function::call(interpreter &interpreter, args_t &&args) -> eval_result_t {
+auto Function::call(interpreter &interpreter, args_t args) -> eval_result_t {
+  return call_method(interpreter, receiver, args);
+}
+auto Function::call_method(interpreter &interpreter,
+                           const IVisitor::variant_type &self,
+                           args_t args) const -> eval_result_t {
   precondition(this->arity() == args.size(),
                "arity mismatch; should check it before calling")
-  return my_function.visit(match(
+  return closure->function.visit(match(
       [&](const native_function_t &native_function) -> eval_result_t {
         return {native_function.operator()(interpreter, args)};
       },
       [&](const custom_function_t &custom_function) -> eval_result_t {
-        auto saved_env = interpreter.get_current_env();
-
-        auto scoped_env = Environment::Scope(this->my_env);
-
-        for (size_t i = 0; i < custom_function.parameters.size(); ++i) {
-          if (auto res =
-                  scoped_env->add(custom_function.parameters[i], args[i]);
-              !res.ok()) {
-            return {res};
-          }
-        }
+        auto saved_upvalues = interpreter.get_current_upvalues();
+
+        // a frame of its own on the interpreter's stack, starting at the
+        // receiver, if any, so the arguments already are the parameters'
+        // slots. outer variables are reached through upvalues.
+        const auto saved_frame = interpreter.push_frame(
+            custom_function.frame_size, args, !self.empty());
+        if (!self.empty())
+          interpreter.frame_slot(0) = self;
+        for (const auto slot : custom_function.captured_parameters)
+          interpreter.capture_slot(slot);
 
         dbg(info, "entering a function...")
-        interpreter.set_env(scoped_env);
-        defer { interpreter.set_env(saved_env); };
+        interpreter.set_upvalues(&closure->upvalues);
+        defer {
+          interpreter.pop_frame(saved_frame);
+          interpreter.set_upvalues(saved_upvalues);
+        };
 
         for (const auto &index : custom_function.body) {
           if (auto res = interpreter.execute(*index); !res) {
             if (res.is_return()) {
-              auto my_result = interpreter.get_result();
-              // FIXME: i my logic was completely gone here: `last_expr`
-              //              itself was a mistake!
-              dbg(info, "returning: {}", my_result->to_string())
-              return my_result;
+              auto my_result = interpreter.take_return_value();
+              dbg(info, "returning: {}", my_result.to_string())
+              return {std::move(my_result)};
             }
             // else, error, return as is
-            return res;
+            return res.as_status();
           }
         }
-        if (is_initializer) {
+        if (closure->is_initializer) {
           dbg(info, "constructor, returning this.")
-          return {*my_env->get_at_depth(0, "this")};
+          return {self};
         }
         dbg(info, "void function, returning nil.")
         return {{NilValue}};
@@ -345,8 +444,11 @@ auto Function::call(interpreter &interpreter, args_t &&args) -> eval_result_t {
       }));
 }
 
+auto operator==(const Function &lhs, const Function &rhs) -> bool {
+  return lhs.closure == rhs.closure && lhs.receiver == rhs.receiver;
+}
 auto Function::to_string(const auxilia::FormatPolicy &) const -> string_type {
-  return my_function.visit(match{
+  return closure->function.visit(match{
       [](const native_function_t &) { return "<native fn>"s; },
       [](const custom_function_t &f) {
         return auxilia::format("<fn {}>", f.name);
@@ -355,67 +457,71 @@ auto Function::to_string(const auxilia::FormatPolicy &) const -> string_type {
   });
 }
 
+auto Shape::find(const symbol_id_t symbol) const noexcept -> size_t {
+  // instances have a few fields: a scan beats hashing.
+  const auto it = std::ranges::find(symbols, symbol);
+  return it == symbols.end() ? npos
+                             : static_cast<size_t>(it - symbols.begin());
+}
+auto Shape::with(const symbol_id_t symbol) const -> const Shape * {
+  auto &next = transitions[symbol];
+  if (!next) {
+    next = std::make_unique<Shape>();
+    next->symbols.reserve(symbols.size() + 1);
+    next->symbols = symbols;
+    next->symbols.push_back(symbol);
+  }
+  return next.get();
+}
+
 Class::Class(const std::string_view name,
-             const uint_least32_t line,
+             const symbol_id_t symbol,
              methods_t &&methods,
-             std::string_view superclass_name,
-             env_ptr_t superclass_env)
-    : Evaluatable(line), name(name), methods(methods),
-      superclass_name(superclass_name), superclass_env(superclass_env) {}
+             IVisitor::variant_type superclass)
+    : name(name), symbol(symbol), methods(std::move(methods)),
+      superclass(std::move(superclass)),
+      base(this->superclass.get_if<Class>()) {
+  // the superclass's table is already flattened; own methods override.
+  if (base)
+    this->methods.insert(base->methods.begin(), base->methods.end());
+  initializer = find_method(SymbolTable::kInit);
+}
 
 auto Class::arity() const -> unsigned {
-  if (auto init = const_cast<Class *>(this)->get_initializer())
-    return init->arity();
+  if (initializer)
+    return initializer->arity();
   return 0;
 }
 
-auto Class::call(interpreter &interpreter, args_t &&variants) -> eval_result_t {
-  auto instance = Instance{interpreter.get_current_env(), name};
-  if (auto initializer = get_initializer())
-    if (auto res =
-            initializer->bind(instance).call(interpreter, std::move(variants));
-        !res)
+auto Class::call(interpreter &interpreter, args_t args) -> eval_result_t {
+  auto instance = IVisitor::variant_type{Instance{lox::Value::share(*this)}};
+  if (initializer)
+    if (auto res = initializer->call_method(interpreter, instance, args); !res)
       return res;
 
   return {instance};
 }
-auto Class::get_method(const std::string_view name) const
+auto Class::get_method(const Token &name) const
     -> auxilia::StatusOr<Function> {
-  if (const auto it = methods.find({name.begin(), name.end()});
-      it != methods.end())
-    return {it->second};
-
-  if (auto superclass = get_superclass())
-    return superclass->get_method(name);
+  if (const auto method = find_method(name.symbol))
+    return {*method};
 
   return auxilia::NotFoundError(
-      "Undefined property '{}'.\n[line {}]", name, get_line());
+      "Undefined property '{}'.\n[line {}]", name.lexeme, name.line);
 }
-auto Class::get_superclass() const -> Class * {
-  if (superclass_env)
-    if (const auto it = superclass_env->find(superclass_name))
-      return &(*it)->second.first.get<Class>();
-
+auto Class::find_method(const symbol_id_t symbol) const -> const Function * {
+  if (const auto it = methods.find(symbol); it != methods.end())
+    return &it->second;
   return nullptr;
 }
 auto Class::to_string(const auxilia::FormatPolicy &) const -> string_type {
   return name;
 }
-auto Class::get_initializer() -> Function * {
-  if (auto it = methods.find("init"); it != methods.end())
-    return &it->second;
-
-  if(auto superclass = get_superclass())
-    return superclass->get_initializer();
-  
-  return nullptr;
-}
-Instance::Instance(const env_ptr_t &env, const std::string_view name)
-    : fields(std::make_shared<fields_t>()), class_env(env), class_name(name) {}
-auto Instance::get_field(const std::string_view name) const -> eval_result_t {
-  if (const auto it = fields->find({name.begin(), name.end()});
-      it != fields->end())
-    return it->second;
+Instance::Instance(IVisitor::variant_type klass)
+    : klass(std::move(klass)), shape(&get_class().get_root_shape()) {}
+auto Instance::get_field(const Token &name) const -> eval_result_t {
+  if (const auto slot = shape->find(name.symbol); slot != Shape::npos)
+    return {fields[slot]};
   // if field not found, find method
   // clang-format off
   return this
@@ -427,25 +533,23 @@ auto Instance::get_field(const std::string_view name) const -> eval_result_t {
       });
   // clang-format on
 }
-auto Instance::set_field(const std::string_view name,
+auto Instance::set_field(const Token &name,
                          eval_result_t &&new_val,
                          const bool shallBeDefined) -> auxilia::Status {
-  if (!shallBeDefined) {
-    // like js or python, we can set a field even if it is not defined yet.
-    fields->insert_or_assign({name.begin(), name.end()}, std::move(new_val));
+  if (const auto slot = shape->find(name.symbol); slot != Shape::npos) {
+    fields[slot] = *std::move(new_val);
     return {};
   }
-  if (auto it = fields->find({name.begin(), name.end()}); it != fields->end()) {
-    it->second = std::move(new_val);
+  if (!shallBeDefined) {
+    // like js or python, we can set a field even if it is not defined yet.
+    shape = shape->with(name.symbol);
+    fields.emplace_back(*std::move(new_val));
     return {};
   }
   return auxilia::NotFoundError(
-      "Undefined property '{}'.\n[line {}]", name, get_line());
+      "Undefined property '{}'.\n[line {}]", name.lexeme, name.line);
 }
 auto Instance::to_string(const auxilia::FormatPolicy &) const -> string_type {
   return get_class().name + " instance";
 }
-auto Instance::get_class() const -> Class & {
-  return (*(class_env->find_symbol(class_name)))->second.first.get<Class>();
-}
 } // namespace accat::lox::evaluation
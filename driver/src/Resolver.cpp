@@ -29,8 +29,8 @@ struct Resolver::scope_guard {
     }
     resolver.scopes.emplace_back();
   }
-  inline constexpr ~scope_guard() noexcept {
-    resolver.scopes.pop_back();
+  inline ~scope_guard() noexcept {
+    resolver.end_scope();
     resolver.current_scope_type = enclosing_scope_type;
   }
 
@@ -44,63 +44,147 @@ Resolver::Resolver(class ::accat::lox::interpreter &interpreter)
     : interpreter(interpreter) {}
 
 auto Resolver::resolve(
-    const std::span<const std::shared_ptr<statement::Stmt>> stmts) const
+    const std::span<statement::Stmt *const> stmts) const
     -> eval_result_t {
   for (const auto &stmt : stmts)
     if (auto res = execute(*stmt); !res)
-      return res;
+      return res.as_status();
 
+  // the locals of top-level blocks live in the frame of the top-level code.
+  if (functions.size() == 1)
+    interpreter.resolve_script_frame(functions.front().frame.size);
   return {};
 }
 
-auto Resolver::resolve_to_interp(
-    const std::shared_ptr<const expression::Expr> &expr, const Token &token)
-    -> eval_result_t {
-  for (auto it = scopes.rbegin(); it != scopes.rend(); ++it)
-    if (it->contains(token.to_string(kDetailed))) {
-      interpreter.resolve(expr, std::ranges::distance(scopes.rbegin(), it));
-      return {};
-    }
+/// @return where @p symbol is as seen from the current function, and its
+/// declaration if it's a local of the current function.
+auto Resolver::lookup(const symbol_id_t symbol)
+    -> std::optional<std::pair<location_t, local_t *>> {
+  for (auto scope = scopes.size(); scope-- > 0;) {
+    auto it = scopes[scope].find(symbol);
+    if (it == scopes[scope].end())
+      continue;
+    auto &local = it->second;
+    if (scope >= functions.back().scope_base)
+      return {{{0, local.slot}, &local}};
+    local.is_captured = true;
+    return {{locate(functions.size() - 1, scope, local.slot), nullptr}};
+  }
+  return std::nullopt;
+}
+/// @brief where the local declared at @p slot of @p scope is, as seen from the
+/// @p function -th function.
+/// @note a local of an enclosing function becomes an upvalue of every function
+/// in between, so that closures capture exactly what they use.
+auto Resolver::locate(const size_t function,
+                      const size_t scope,
+                      const size_t slot) -> location_t {
+  if (scope >= functions[function].scope_base)
+    return {0, slot};
+
+  const auto capture = locate(function - 1, scope, slot);
+  auto &captures = functions[function].frame.captures;
+  auto it = std::ranges::find(captures, capture);
+  if (it == captures.end())
+    it = captures.insert(captures.end(), capture);
+  return {location_t::upvalue_depth,
+          static_cast<size_t>(std::ranges::distance(captures.begin(), it))};
+}
+auto Resolver::resolve_to_interp(const expression::Expr &expr,
+                                 const Token &token) -> eval_result_t {
+  if (const auto found = lookup(token.symbol)) {
+    bind(interpreter.resolve(expr, found->first), found->second);
+    return {};
+  }
+  // not found in any local scope: it's a global.
+  interpreter.resolve_global(expr, token.symbol);
   return {};
 }
+auto Resolver::resolve_to_interp(const statement::Stmt &stmt,
+                                 const Token &token) -> eval_result_t {
+  if (scopes.empty()) {
+    interpreter.resolve_global(stmt, token.symbol);
+    return {};
+  }
+  auto &local = scopes.back().at(token.symbol);
+  bind(interpreter.resolve(stmt, {0, local.slot}), &local);
+  return {};
+}
+void Resolver::bind(location_t &location, local_t *local) {
+  if (local)
+    local->uses.push_back(&location);
+}
 auto Resolver::resolve(const statement::Function &stmt,
                        const ScopeType scopeType) -> eval_result_t {
-  define(stmt.name);
+  functions.push_back({.scope_base = scopes.size()});
+  defer { functions.pop_back(); };
+  eval_result_t res;
+  {
+    scope_guard guard(*this, scopeType);
 
-  scope_guard guard(*this, scopeType);
+    // the receiver of a method is its first slot.
+    if (scopeType == ScopeType::kMethod || scopeType == ScopeType::kInitializer)
+      add_to_scope(SymbolTable::kThis, true);
 
-  for (const auto &param : stmt.parameters) {
-    if (is_defined(param))
-      return {InvalidArgumentError("[line {}] Error at '{}': "
-                                   "Already a variable with this name in "
-                                   "this scope.",
-                                   param.line,
-                                   param.to_string(kDetailed))};
-    define(param);
-  }
+    for (const auto &param : stmt.parameters) {
+      if (is_defined(param))
+        return {InvalidArgumentError("[line {}] Error at '{}': "
+                                     "Already a variable with this name in "
+                                     "this scope.",
+                                     param.line,
+                                     param.to_string(kDetailed))};
+      // parameters occupy the next slots, in order.
+      define(param);
+    }
+    functions.back().parameter_slots = functions.back().next_slot;
 
-  return resolve(stmt.body.statements);
+    res = resolve(stmt.body.statements);
+  }
+  interpreter.resolve_frame(stmt, std::move(functions.back().frame));
+  return res;
 }
 void Resolver::declare(const Token &token) {
-  return this->add_to_scope(token, false);
+  return this->add_to_scope(token.symbol, false);
 }
 void Resolver::define(const Token &token) {
-  return this->add_to_scope(token, true);
+  return this->add_to_scope(token.symbol, true);
 }
 bool Resolver::is_defined(const Token &token) const {
   if (scopes.empty())
     return false;
-  if (auto it = scopes.back().find(token.to_string(kDetailed));
+  if (auto it = scopes.back().find(token.symbol);
       it != scopes.back().end()) {
-    return it->second;
+    return it->second.is_defined;
   }
   return false;
 }
 
-void Resolver::add_to_scope(const Token &token, const bool is_defined) {
+void Resolver::add_to_scope(const symbol_id_t symbol, const bool is_defined) {
   if (scopes.empty())
     return;
-  scopes.back().insert_or_assign(token.to_string(kDetailed), is_defined);
+  auto &function = functions.back();
+  // a redeclared name keeps its slot.
+  if (auto [it, inserted] =
+          scopes.back().try_emplace(symbol, local_t{function.next_slot, is_defined});
+      !inserted)
+    it->second.is_defined = is_defined;
+  else
+    function.frame.size = std::max(function.frame.size, ++function.next_slot);
+}
+/// @brief leave the innermost scope: its slots are free for the next block, and
+/// its captured locals are moved to cells wherever they're used.
+void Resolver::end_scope() {
+  auto &function = functions.back();
+  for (const auto &[symbol, local] : scopes.back()) {
+    if (!local.is_captured)
+      continue;
+    for (const auto location : local.uses)
+      location->depth = location_t::cell_depth;
+    if (local.slot < function.parameter_slots)
+      function.frame.captured_parameters.push_back(local.slot);
+  }
+  function.next_slot -= scopes.back().size();
+  scopes.pop_back();
 }
 auto Resolver::visit2(const expression::Literal &) -> eval_result_t {
   // nothing to do
@@ -112,24 +196,23 @@ auto Resolver::visit2(const expression::Unary &expr) -> eval_result_t {
 auto Resolver::visit2(const expression::Binary &expr) -> eval_result_t {
   return evaluate(*expr.left) && evaluate(*expr.right);
 }
-auto Resolver::visit2(const expression::Grouping &) -> eval_result_t {
-  // nothing to do
-  return {};
+auto Resolver::visit2(const expression::Grouping &expr) -> eval_result_t {
+  return evaluate(*expr.expr);
 }
 auto Resolver::visit2(const expression::Variable &expr) -> eval_result_t {
   if (!scopes.empty() and
-      scopes.back().contains(expr.name.to_string(kDetailed)) and
-      scopes.back()[expr.name.to_string(kDetailed)] == false) {
+      scopes.back().contains(expr.name.symbol) and
+      scopes.back()[expr.name.symbol].is_defined == false) {
     return {InvalidArgumentError("[line {}] Error at '{}': Can't read "
                                  "local variable in its own initializer.",
                                  expr.name.line,
                                  expr.name.to_string(kDetailed))};
   }
-  return resolve_to_interp(expr.shared_from_this(), expr.name);
+  return resolve_to_interp(expr, expr.name);
 }
 auto Resolver::visit2(const expression::Assignment &expr) -> eval_result_t {
   return evaluate(*expr.value_expr) &&
-         resolve_to_interp(expr.shared_from_this(), expr.name);
+         resolve_to_interp(expr, expr.name);
 }
 auto Resolver::visit2(const expression::Logical &expr) -> eval_result_t {
   return evaluate(*expr.left) && evaluate(*expr.right);
@@ -157,7 +240,7 @@ auto Resolver::visit2(const expression::This &expr) -> eval_result_t {
                    "class.",
                    expr.name.line,
                    expr.name.to_string(kDetailed))
-             : resolve_to_interp(expr.shared_from_this(), expr.name);
+             : resolve_to_interp(expr, expr.name);
 }
 auto Resolver::visit2(const expression::Super &expr) -> eval_result_t {
   if (current_class_type == ClassType::kNone)
@@ -173,14 +256,20 @@ auto Resolver::visit2(const expression::Super &expr) -> eval_result_t {
         expr.name.line,
         expr.name.to_string(kDetailed))};
   // current class type is kDerivedClass
-  return resolve_to_interp(expr.shared_from_this(), expr.name);
+  const auto superclass = lookup(SymbolTable::kSuper);
+  const auto receiver = lookup(SymbolTable::kThis);
+  contract_assert(superclass && receiver,
+                  "'super' and 'this' shall be in scope within a method")
+  bind(interpreter.resolve(expr, superclass->first), superclass->second);
+  bind(interpreter.resolve(expr.method, receiver->first), receiver->second);
+  return {};
 }
 auto Resolver::evaluate4(const expression::Expr &expr) -> eval_result_t {
-  return expr.accept(*this);
+  return this->dispatch(expr);
 }
 auto Resolver::get_result_impl() const -> eval_result_t { TODO() }
 
-auto Resolver::visit2(const statement::Variable &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Variable &stmt) -> exec_result_t {
   if (is_defined(stmt.name))
     return {InvalidArgumentError("[line {}] Error at '{}': "
                                  "Already a variable with this name in "
@@ -195,23 +284,24 @@ auto Resolver::visit2(const statement::Variable &stmt) -> eval_result_t {
       return res;
 
   define(stmt.name);
-  return {};
+  return resolve_to_interp(stmt, stmt.name);
 }
-auto Resolver::visit2(const statement::Print &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Print &stmt) -> exec_result_t {
   return evaluate(*stmt.value);
 }
-auto Resolver::visit2(const statement::Expression &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Expression &stmt) -> exec_result_t {
   return evaluate(*stmt.expr);
 }
-auto Resolver::visit2(const statement::If &stmt) -> eval_result_t {
-  return evaluate(*stmt.condition) && execute(*stmt.then_branch) &&
+auto Resolver::visit2(const statement::If &stmt) -> exec_result_t {
+  return evaluate(*stmt.condition) &&
+         execute(*stmt.then_branch).as_status() &&
          (stmt.else_branch ? execute(*stmt.else_branch).as_status()
                            : OkStatus());
 }
-auto Resolver::visit2(const statement::While &stmt) -> eval_result_t {
-  return evaluate(*stmt.condition) && execute(*stmt.body);
+auto Resolver::visit2(const statement::While &stmt) -> exec_result_t {
+  return evaluate(*stmt.condition) && execute(*stmt.body).as_status();
 }
-auto Resolver::visit2(const statement::For &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::For &stmt) -> exec_result_t {
   // should not exists, should be desugared in the parser.
   // nonetheless I did not desugar it.
 
@@ -230,11 +320,14 @@ auto Resolver::visit2(const statement::For &stmt) -> eval_result_t {
          (stmt.body ? execute(*stmt.body).as_status() : OkStatus()) &&
          (stmt.increment ? evaluate(*stmt.increment).as_status() : OkStatus());
 }
-auto Resolver::visit2(const statement::Function &stmt) -> eval_result_t {
-  return resolve(stmt, ScopeType::kFunction);
+auto Resolver::visit2(const statement::Function &stmt) -> exec_result_t {
+  define(stmt.name);
+  return resolve_to_interp(stmt, stmt.name) &&
+         resolve(stmt, ScopeType::kFunction);
 }
-auto Resolver::visit2(const statement::Class &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Class &stmt) -> exec_result_t {
   define(stmt.name);
+  resolve_to_interp(stmt, stmt.name).ignore_error();
 
   auto enclosing_class_type = this->current_class_type;
   this->current_class_type = ClassType::kClass;
@@ -252,25 +345,26 @@ auto Resolver::visit2(const statement::Class &stmt) -> eval_result_t {
     if (auto res = visit2(*stmt.superclass); !res) {
       return res;
     }
-    this->scopes.emplace_back().emplace("super", true);
+    // `super` is a local of the enclosing function the methods capture.
+    this->scopes.emplace_back();
+    add_to_scope(SymbolTable::kSuper, true);
+    auto &local = scopes.back().at(SymbolTable::kSuper);
+    bind(interpreter.resolve(stmt.superclass->name, {0, local.slot}), &local);
   }
 
-  scope_guard guard(*this, ScopeType::kNone);
-  this->scopes.back().emplace("this", true);
-
   for (const auto &method : stmt.methods)
     if (auto res = resolve(method,
-                           method.name.to_string(kDetailed) == "init"
+                           method.name.symbol == SymbolTable::kInit
                                ? ScopeType::kInitializer
                                : ScopeType::kMethod);
         !res)
       // TODO: restore scope if the class has superclass.?(see below)
       return res;
   if (stmt.superclass)
-    this->scopes.pop_back(); // pop the super class scope.
+    end_scope(); // pop the super class scope.
   return {};
 }
-auto Resolver::visit2(const statement::Return &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Return &stmt) -> exec_result_t {
   if (this->current_scope_type == ScopeType::kNone)
     return {InvalidArgumentError("[line {}] Error at '{}': "
                                  "Can't return from top-level code.",
@@ -284,10 +378,10 @@ auto Resolver::visit2(const statement::Return &stmt) -> eval_result_t {
                                  "return")};
   return stmt.value ? evaluate(*stmt.value).as_status() : OkStatus();
 }
-auto Resolver::execute4(const statement::Stmt &stmt) -> eval_result_t {
-  return stmt.accept(*this);
+auto Resolver::execute4(const statement::Stmt &stmt) -> exec_result_t {
+  return this->dispatch(stmt);
 }
-auto Resolver::visit2(const statement::Block &stmt) -> eval_result_t {
+auto Resolver::visit2(const statement::Block &stmt) -> exec_result_t {
   scope_guard guard(*this, ScopeType::kNone);
 
   return resolve(stmt.statements);
@@ -12,13 +12,13 @@
 #include "Evaluatable.hpp"
 
 namespace accat::lox::evaluation {
-auxilia::Status ScopeAssoc::add(string_view_type name,
+auxilia::Status ScopeAssoc::add(const symbol_id_t name,
                                 const variant_type &value,
                                 const uint_least32_t line) {
   if (is_symbol(value))
     return add_symbol(name, value, line);
 
-  if (variables.contains({name.data(), name.size()})) {
+  if (variables.contains(name)) {
     /// Scheme allows redefining variables at the top level; so temporarily
     /// we just follow that.
     dbg(warn,
@@ -26,13 +26,13 @@ auxilia::Status ScopeAssoc::add(string_view_type name,
         "it...",
         name)
   }
-  variables.insert_or_assign(name.data(), std::pair{value, line});
+  variables.insert_or_assign(name, std::pair{value, line});
   return {};
 }
-auto ScopeAssoc::add_symbol(string_view_type name,
+auto ScopeAssoc::add_symbol(const symbol_id_t name,
                             const variant_type &value,
                             uint_least32_t line) -> auxilia::Status {
-  if (auto it = symbols.find({name.data(), name.size()}); it != symbols.end()) {
+  if (auto it = symbols.find(name); it != symbols.end()) {
     if (it->second.first.index() != value.index()) {
       return auxilia::InvalidArgumentError(
           "redefine a symbol with a different type is not "
@@ -43,7 +43,7 @@ auto ScopeAssoc::add_symbol(string_view_type name,
         "it...",
         name)
   }
-  symbols.insert_or_assign(name.data(), std::pair{value, line});
+  symbols.insert_or_assign(name, std::pair{value, line});
   return {};
 }
 auto ScopeAssoc::to_string(const auxilia::FormatPolicy &format_policy) const
@@ -51,10 +51,10 @@ auto ScopeAssoc::to_string(const auxilia::FormatPolicy &format_policy) const
   std::ostringstream oss;
   oss << "[ ";
   for (const auto &[key, value] : variables) {
-    oss << key << ": " << value.first.to_string(format_policy) << ", ";
+    oss << "#" << key << ": " << value.first.to_string(format_policy) << ", ";
   }
   for (const auto &[key, value] : symbols) {
-    oss << key << ": " << value.first.to_string(format_policy) << ", ";
+    oss << "#" << key << ": " << value.first.to_string(format_policy) << ", ";
   }
 
   if (variables.size() + symbols.size() == 0)
@@ -65,33 +65,33 @@ auto ScopeAssoc::to_string(const auxilia::FormatPolicy &format_policy) const
   oss << auxilia::format(" ({} entries) ", variables.size());
   return oss.str();
 }
-auto ScopeAssoc::find(const string_view_type name)
+auto ScopeAssoc::find(const symbol_id_t name)
     -> std::optional<associations_t::iterator> {
-  if (auto it = variables.find({name.data(), name.size()});
+  if (auto it = variables.find(name);
       it != variables.end())
     return {it};
-  if (auto it = symbols.find({name.data(), name.size()}); it != symbols.end())
+  if (auto it = symbols.find(name); it != symbols.end())
     return {it};
   return std::nullopt;
 }
-auto ScopeAssoc::find(const string_view_type name) const
+auto ScopeAssoc::find(const symbol_id_t name) const
     -> std::optional<associations_t::const_iterator> {
-  if (auto it = variables.find({name.data(), name.size()});
+  if (auto it = variables.find(name);
       it != variables.end())
     return {it};
-  if (auto it = symbols.find({name.data(), name.size()}); it != symbols.end())
+  if (auto it = symbols.find(name); it != symbols.end())
     return {it};
   return std::nullopt;
 }
-auto ScopeAssoc::find_symbol(const string_view_type name)
+auto ScopeAssoc::find_symbol(const symbol_id_t name)
     -> std::optional<associations_t::iterator> {
-  if (auto it = symbols.find({name.data(), name.size()}); it != symbols.end())
+  if (auto it = symbols.find(name); it != symbols.end())
     return {it};
   return std::nullopt;
 }
-auto ScopeAssoc::find_symbol(const string_view_type name) const
+auto ScopeAssoc::find_symbol(const symbol_id_t name) const
     -> std::optional<associations_t::const_iterator> {
-  if (auto it = symbols.find({name.data(), name.size()}); it != symbols.end())
+  if (auto it = symbols.find(name); it != symbols.end())
     return {it};
   return std::nullopt;
 }
@@ -0,0 +1,41 @@
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+#include "SymbolTable.hpp"
+
+namespace accat::lox {
+SymbolTable::SymbolTable() {
+  // keep in sync with the enumerators.
+  for (const auto name : {"this"sv, "super"sv, "init"sv, "clock"sv, "about"sv})
+    intern(name);
+}
+auto SymbolTable::intern(const string_view_type name) -> symbol_type {
+  if (const auto it = ids.find(name); it != ids.end())
+    return it->second;
+  const auto id = static_cast<symbol_type>(names.size());
+  ids.emplace(names.emplace_back(name), id);
+  return id;
+}
+auto SymbolTable::find(const string_view_type name) const -> symbol_type {
+  if (const auto it = ids.find(name); it != ids.end())
+    return it->second;
+  return kInvalid;
+}
+auto SymbolTable::name_of(const symbol_type id) const -> string_view_type {
+  if (id >= names.size())
+    return "<invalid symbol>"sv;
+  return names[id];
+}
+auto SymbolTable::to_string(const auxilia::FormatPolicy &) const
+    -> string_type {
+  std::ostringstream oss;
+  for (size_t i = 0; i < names.size(); ++i)
+    oss << i << ": " << names[i] << "\n";
+  return oss.str();
+}
+} // namespace accat::lox
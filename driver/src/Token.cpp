@@ -18,7 +18,7 @@ namespace accat::lox {
 using enum auxilia::FormatPolicy;
 Token::string_type
 Token::number_to_string(const auxilia::FormatPolicy policy) const {
-  if (auto ptr = literal.get_if<long double>()) {
+  if (auto ptr = literal.get_if<double>()) {
     // 42 -> 42.0
     if (auxilia::is_integer(*ptr)) {
       if (policy == kDefault)
@@ -0,0 +1,67 @@
+#include "Value.hpp"
+
+#include <accat/auxilia/auxilia.hpp>
+
+#include "details/lox_fwd.hpp"
+
+#include "Evaluatable.hpp"
+
+namespace accat::lox {
+auto Value::destroy() noexcept -> void {
+  switch (kind()) {
+  case Kind::kString:
+    delete static_cast<evaluation::String *>(object());
+    break;
+  case Kind::kFunction:
+    delete static_cast<evaluation::Function *>(object());
+    break;
+  case Kind::kClass:
+    delete static_cast<evaluation::Class *>(object());
+    break;
+  case Kind::kInstance:
+    delete static_cast<evaluation::Instance *>(object());
+    break;
+  }
+}
+auto Value::equal_objects(const Value &lhs, const Value &rhs) -> bool {
+  switch (lhs.kind()) {
+  case Kind::kString:
+    return (lhs.get<evaluation::String>() == rhs.get<evaluation::String>())
+        .is_true();
+  case Kind::kFunction:
+    return lhs.get<evaluation::Function>() == rhs.get<evaluation::Function>();
+  case Kind::kClass:
+    return lhs.get<evaluation::Class>() == rhs.get<evaluation::Class>();
+  case Kind::kInstance:
+    return lhs.get<evaluation::Instance>() == rhs.get<evaluation::Instance>();
+  }
+  return false;
+}
+auto Value::to_string(const auxilia::FormatPolicy &format_policy) const
+    -> string_type {
+  if (is_number())
+    return get<evaluation::Number>().to_string(format_policy);
+  if (is_object()) {
+    switch (kind()) {
+    case Kind::kString:
+      return get<evaluation::String>().to_string(format_policy);
+    case Kind::kFunction:
+      return get<evaluation::Function>().to_string(format_policy);
+    case Kind::kClass:
+      return get<evaluation::Class>().to_string(format_policy);
+    case Kind::kInstance:
+      return get<evaluation::Instance>().to_string(format_policy);
+    }
+  }
+  switch (bits) {
+  case kNil:
+    return evaluation::NilValue.to_string(format_policy);
+  case kTrue:
+    return evaluation::True.to_string(format_policy);
+  case kFalse:
+    return evaluation::False.to_string(format_policy);
+  default:
+    return {};
+  }
+}
+} // namespace accat::lox
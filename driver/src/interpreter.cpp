@@ -29,42 +29,135 @@ using enum TokenType::type_t;
 using enum auxilia::FormatPolicy;
 
 #pragma region env
-struct interpreter::environment_guard {
-  class interpreter &interpreter;
-  env_ptr_t original_env;
-  inline explicit environment_guard(class interpreter &interpreter) noexcept
-      : interpreter(interpreter), original_env(interpreter.env) {
-    interpreter.env = Environment::Scope(original_env);
-  }
-  inline ~environment_guard() noexcept { interpreter.env = original_env; }
-};
-
-interpreter::interpreter() : env(std::make_shared<Environment>()) {}
+interpreter::interpreter(std::shared_ptr<SymbolTable> symbols)
+    : env(std::make_shared<Environment>()), globals(env),
+      symbols(std::move(symbols)) {}
 auto interpreter::interpret(
-    const std::span<std::shared_ptr<statement::Stmt>> stmts) -> eval_result_t {
+    const std::span<statement::Stmt *const> stmts) -> eval_result_t {
   is_interpreting_stmts = true;
-  this->env = Environment::Global();
+  this->env = this->globals = Environment::Global();
+  bind_globals();
+  stack.resize(script_frame_size);
+  stack_cells.resize(script_frame_size);
 
   for (const auto &stmt : stmts)
-    if (auto eval_res = execute(*stmt); !eval_res) {
-      last_expr_res->clear();
-      return eval_res;
-    }
+    if (auto exec_res = execute(*stmt); !exec_res)
+      return exec_res.as_status();
 
   return {};
 }
-size_t interpreter::resolve(const std::shared_ptr<const expression::Expr> &expr,
-                            const size_t depth) {
-  return local_env.emplace(expr, depth);
+auto interpreter::stream() -> interpreter & {
+  is_interpreting_stmts = true;
+  this->env = this->globals = Environment::Global();
+  local_env.journaling = true;
+  return *this;
+}
+auto interpreter::interpret_next(const statement::Stmt &stmt)
+    -> eval_result_t {
+  // the statement may have brought new globals and deeper top-level blocks.
+  bind_globals();
+  stack.resize(script_frame_size);
+  stack_cells.resize(script_frame_size);
+
+  if (auto exec_res = execute(stmt); !exec_res)
+    return exec_res.as_status();
+  return {};
+}
+void interpreter::retire(const bool keep) {
+  if (keep)
+    local_env.commit();
+  else
+    local_env.rollback();
+}
+auto interpreter::evaluate_expression(const expression::Expr &expr)
+    -> eval_result_t {
+  auto res = evaluate(expr);
+  if (res)
+    expression_result = res;
+  return res;
+}
+auto interpreter::resolve(const expression::Expr &expr,
+                          const location_t &location) -> location_t & {
+  return local_env.emplace(expr, location);
+}
+auto interpreter::resolve(const statement::Stmt &stmt,
+                          const location_t &location) -> location_t & {
+  return local_env.emplace(stmt, location);
+}
+auto interpreter::resolve(const Token &token, const location_t &location)
+    -> location_t & {
+  return local_env.emplace(token, location);
+}
+void interpreter::resolve_global(const expression::Expr &expr,
+                                 const symbol_id_t symbol) {
+  local_env.emplace(expr, {location_t::global_depth, global_slot(symbol)});
+}
+void interpreter::resolve_global(const statement::Stmt &stmt,
+                                 const symbol_id_t symbol) {
+  local_env.emplace(stmt, {location_t::global_depth, global_slot(symbol)});
+}
+void interpreter::resolve_frame(const statement::Function &stmt,
+                                frame_t &&frame) {
+  frames.insert_or_assign(&stmt, std::move(frame));
+}
+void interpreter::resolve_script_frame(const size_t size) {
+  script_frame_size = std::max(script_frame_size, size);
+}
+auto interpreter::global_slot(const symbol_id_t symbol) -> size_t {
+  const auto [it, inserted] =
+      global_slots.try_emplace(symbol, global_slots.size());
+  if (inserted)
+    unbound_globals.emplace_back(symbol, it->second);
+  return it->second;
+}
+/// @brief copy what is already defined by name(the natives) into the slots the
+/// Resolver assigned since the last call, so that resolved reads never take the
+/// by-name path.
+void interpreter::bind_globals() {
+  for (const auto &[symbol, slot] : unbound_globals)
+    if (const auto value = globals->get(symbol, true); value && !value->empty())
+      globals->define_at(slot, symbol, *value);
+  unbound_globals.clear();
 }
 
 auto interpreter::set_env(const env_ptr_t &new_env) -> interpreter & {
   env = new_env;
   return *this;
 }
+auto interpreter::set_upvalues(const upvalues_t *new_upvalues)
+    -> interpreter & {
+  upvalues = new_upvalues;
+  return *this;
+}
+auto interpreter::push_frame(const size_t size,
+                             const evaluation::Callable::args_t args,
+                             const bool has_receiver) -> size_t {
+  const auto enclosing_base = frame_base;
+  frame_base = static_cast<size_t>(args.data() - stack.data()) - has_receiver;
+  stack.resize(frame_base + size);
+  stack_cells.resize(frame_base + size);
+  ++call_depth;
+  return enclosing_base;
+}
+void interpreter::pop_frame(const size_t enclosing_base) {
+  stack.resize(frame_base);
+  stack_cells.resize(frame_base);
+  frame_base = enclosing_base;
+  --call_depth;
+}
+auto interpreter::frame_slot(const size_t slot) -> variant_type & {
+  return stack[frame_base + slot];
+}
+auto interpreter::capture_slot(const size_t slot) -> upvalues_t::value_type {
+  auto &cell = stack_cells[frame_base + slot];
+  if (!cell)
+    cell = std::make_shared<variant_type>(std::move(stack[frame_base + slot]));
+  return cell;
+}
 #pragma endregion env
 #pragma region statement
-auto interpreter::visit2(const statement::Variable &stmt) -> eval_result_t {
+auto interpreter::visit2(const statement::Variable &stmt) -> exec_result_t {
+  declare_variable(stmt);
 
   if (stmt.has_initializer()) {
     auto eval_res = evaluate(*stmt.initializer);
@@ -76,22 +169,19 @@ auto interpreter::visit2(const statement::Variable &stmt) -> eval_result_t {
         "variable name: {}, value: {}",
         stmt.name.literal.get<string_view_type>(),
         eval_res->to_string())
-    // string view failed again; not null-terminated
-    return {
-        env->add(stmt.name.to_string(kDetailed), *eval_res, stmt.name.line)};
+    return {define_variable(stmt, stmt.name, *eval_res)};
   }
   // if no initializer, it's a nil value.
-  return env->add(
-      stmt.name.to_string(kDetailed), evaluation::NilValue, stmt.name.line);
+  return define_variable(stmt, stmt.name, evaluation::NilValue);
 }
-auto interpreter::visit2(const statement::Print &stmt) -> eval_result_t {
+auto interpreter::visit2(const statement::Print &stmt) -> exec_result_t {
   auto eval_res = evaluate(*stmt.value);
   if (!eval_res)
     return eval_res;
   stmts_res.emplace_back(*eval_res);
-  return {{evaluation::NilValue}};
+  return {};
 }
-auto interpreter::visit2(const statement::If &stmt) -> eval_result_t {
+auto interpreter::visit2(const statement::If &stmt) -> exec_result_t {
   auto eval_res = evaluate(*stmt.condition);
   if (!eval_res)
     return eval_res;
@@ -102,27 +192,21 @@ auto interpreter::visit2(const statement::If &stmt) -> eval_result_t {
   if (stmt.else_branch) { // maybe we dont have an else branch, so check it.
     return execute(*stmt.else_branch);
   }
-  return {*eval_res};
+  return {};
 }
-auto interpreter::visit2(const statement::While &stmt) -> eval_result_t {
-  eval_result_t res;
-  do {
+auto interpreter::visit2(const statement::While &stmt) -> exec_result_t {
+  while (true) {
     auto eval_res = evaluate(*stmt.condition);
     if (!eval_res)
       return eval_res;
     if (not is_true_value(*eval_res).is_true())
       break;
-    res = execute(*stmt.body);
-    if (!res)
+    if (auto res = execute(*stmt.body); !res)
       return res;
-  } while (true);
-
-  return {*res};
+  }
+  return {};
 }
-auto interpreter::visit2(const statement::For &stmt) -> eval_result_t {
-
-  environment_guard guard(*this);
-
+auto interpreter::visit2(const statement::For &stmt) -> exec_result_t {
   if (stmt.initializer)
     if (auto res = execute(*stmt.initializer); !res)
       return res;
@@ -144,15 +228,14 @@ auto interpreter::visit2(const statement::For &stmt) -> eval_result_t {
   }
   return {};
 }
-auto interpreter::visit2(const statement::Function &stmt) -> eval_result_t {
+auto interpreter::visit2(const statement::Function &stmt) -> exec_result_t {
   // TODO: function overloading
-  if (auto res = env->get(stmt.name.to_string(kDetailed));
-      res && !res->empty()) {
+  if (auto res = env->get(stmt.name.symbol); res && !res->empty()) {
     if (!res->is_type<evaluation::Function>()) {
       dbg(error,
           "bad function definition: {} is not a function",
           stmt.name.to_string(kDetailed))
-      return *res;
+      return {};
     }
     // if arity is same, warn and overwrite the function;
     // if arity is different, just as overloading.
@@ -167,14 +250,20 @@ auto interpreter::visit2(const statement::Function &stmt) -> eval_result_t {
 
   dbg(trace, "func name: {}", stmt.name.to_string(kDetailed))
 
-  return env->add(
-      stmt.name.to_string(kDetailed), get_function(stmt), stmt.name.line);
+  // the function may capture itself.
+  declare_variable(stmt);
+  return define_variable(stmt, stmt.name, get_function(stmt));
 }
-auto interpreter::visit2(const statement::Class &stmt) -> eval_result_t {
-  if (auto res = env->find(stmt.name.to_string(kDetailed)); res) {
+auto interpreter::visit2(const statement::Class &stmt) -> exec_result_t {
+  // only a global class may not be redefined; a local one resolves to a slot
+  // of its frame and so shadows a global class of the same name.
+  if (const auto &location = local_env.find(stmt)->second;
+      location.depth == location_t::global_depth && lookup(location)) {
     TODO(...)
   }
-  env_ptr_t supEnv;
+  // methods may capture the class.
+  declare_variable(stmt);
+  variant_type superclass;
   if (stmt.superclass) {
     // design flaw
     auto res = visit2(*stmt.superclass);
@@ -184,72 +273,66 @@ auto interpreter::visit2(const statement::Class &stmt) -> eval_result_t {
       return auxilia::InvalidArgumentError(
           "Superclass must be a class.\n[line {}]", stmt.superclass->name.line);
 
-    /// cannot use environment_guard here -- scope issue
-    env = Environment::Scope(env);
-    env->add("super", *res, stmt.superclass->name.line);
-    supEnv = env;
+    superclass = *res;
+    // `super` is a local of the enclosing frame the methods capture.
+    const auto &location = local_env.find(stmt.superclass->name)->second;
+    declare_at(location);
+    define_at(location, SymbolTable::kSuper, *res);
   }
 
   evaluation::Class::methods_t methods;
   std::ranges::for_each(stmt.methods, [this, &methods](auto &&method) {
-    auto name = method.name.to_string(kDetailed);
-    methods.emplace(name, get_function(method, name == "init" ? true : false));
+    methods.emplace(
+        method.name.symbol,
+        get_function(method, method.name.symbol == SymbolTable::kInit));
   });
 
-  if (stmt.superclass)
-    env = env->ancestor(1);
-
-  return env->add(
-      stmt.name.to_string(kDetailed),
+  return define_variable(
+      stmt,
+      stmt.name,
       evaluation::Class{stmt.name.to_string(kDetailed),
-                        stmt.name.line,
+                        stmt.name.symbol,
                         std::move(methods),
-                        stmt.superclass
-                            ? stmt.superclass->name.to_string(kDetailed)
-                            : std::string{},
-                        std::move(supEnv)},
-      stmt.name.line);
+                        std::move(superclass)});
 }
-auto interpreter::visit2(const statement::Expression &stmt) -> eval_result_t {
+auto interpreter::visit2(const statement::Expression &stmt) -> exec_result_t {
   return evaluate(*stmt.expr);
 }
-auto interpreter::visit2(const statement::Block &stmt) -> eval_result_t {
-
-  environment_guard guard(*this);
-
+auto interpreter::visit2(const statement::Block &stmt) -> exec_result_t {
+  // the locals of a block are slots of the enclosing frame.
   for (const auto &scoped_stmt : stmt.statements)
     if (auto eval_res = execute(*scoped_stmt); !eval_res)
       return eval_res;
 
   return {};
 }
-auto interpreter::execute4(const statement::Stmt &stmt) -> eval_result_t {
-  return stmt.accept(*this);
+auto interpreter::execute4(const statement::Stmt &stmt) -> exec_result_t {
+  return this->dispatch(stmt);
 }
 #pragma endregion statement
 #pragma region expression
 auto interpreter::get_result_impl() const -> eval_result_t {
-  return last_expr_res;
+  return expression_result;
 }
 
 auto interpreter::evaluate4(const expression::Expr &expr) -> eval_result_t {
-  auto res = expr.accept(*this);
+  auto res = this->dispatch(expr);
   if (!res)
     return res;
   dbg(info,
       "result: {}",
       res->is_type<auxilia::Monostate>() ? "<nothing>" : res->to_string())
-  return last_expr_res.reset(*std::move(res));
+  return res;
 }
-auto interpreter::visit2(const statement::Return &expr) -> eval_result_t {
-  if (this->env == Environment::Global()) {
+auto interpreter::visit2(const statement::Return &expr) -> exec_result_t {
+  if (call_depth == 0) {
     return {
         auxilia::InvalidArgumentError("Cannot return from top-level code.")};
   }
 
   if (not expr.value) {
     dbg(info, "returning nil")
-    return Returning({{evaluation::NilValue}});
+    return Returning(evaluation::NilValue);
   }
   auto res = evaluate(*expr.value);
   dbg(info, "return value: {}", res->to_string())
@@ -257,41 +340,18 @@ auto interpreter::visit2(const statement::Return &expr) -> eval_result_t {
     return res;
   }
   dbg(trace, "result: {}", res->to_string())
-  return Returning(*res);
+  return Returning(*std::move(res));
 }
 auto interpreter::visit2(const expression::Literal &expr) -> eval_result_t {
-  dbg(trace, "literal type: {}", expr.literal.type)
-
-  auto T = [&expr](const TokenType::type_t t) constexpr noexcept -> bool {
-    return expr.literal.is_type(t);
-  };
-
-  if (T(kMonostate)) {
-    dbg_break
-  }
-  if (T(kNil)) {
-    return {evaluation::Nil{expr.literal.line}};
-  }
-  if (T(kTrue)) {
-    return {evaluation::Boolean{true, expr.literal.line}};
-  }
-  if (T(kFalse)) {
-    return {evaluation::Boolean{false, expr.literal.line}};
-  }
-  if (T(kString)) {
-    return {evaluation::String{expr.literal.literal.get<string_view_type>(),
-                               expr.literal.line}};
-  }
-  if (T(kNumber)) {
-    return {evaluation::Number{expr.literal.literal.get<long double>(),
-                               expr.literal.line}};
-  }
+  // made by the parser; a copy shares the string, if any.
+  if (!expr.value.empty())
+    return {expr.value};
   return {auxilia::InvalidArgumentError("Expected literal value.\n[line {}]",
                                         expr.literal.line)};
 }
 
 auto interpreter::visit2(const expression::Unary &expr) -> eval_result_t {
-  auto inner_expr = expr.expr->accept(*this);
+  auto inner_expr = evaluate(*expr.expr);
   if (expr.op.is_type(kMinus)) {
     if (inner_expr->is_type<evaluation::Number>()) {
       auto value = inner_expr->get<evaluation::Number>();
@@ -311,12 +371,12 @@ auto interpreter::visit2(const expression::Unary &expr) -> eval_result_t {
 }
 
 auto interpreter::visit2(const expression::Binary &expr) -> eval_result_t {
-  auto lhs = expr.left->accept(*this);
+  auto lhs = evaluate(*expr.left);
   if (!lhs) {
     return lhs;
   }
 
-  auto rhs = expr.right->accept(*this);
+  auto rhs = evaluate(*expr.right);
   if (!rhs) {
     return rhs;
   }
@@ -338,9 +398,9 @@ auto interpreter::visit2(const expression::Binary &expr) -> eval_result_t {
   }
   if (lhs->is_type<evaluation::String>()) {
     if (expr.op.is_type(kPlus)) {
-      auto str_lhs = lhs->get<evaluation::String>();
-      auto str_rhs = rhs->get<evaluation::String>();
-      return {evaluation::String{str_lhs + str_rhs}};
+      const auto &str_lhs = lhs->get<evaluation::String>();
+      const auto &str_rhs = rhs->get<evaluation::String>();
+      return {str_lhs + str_rhs};
     }
   }
   if (lhs->is_type<evaluation::Number>()) {
@@ -396,25 +456,24 @@ auto interpreter::visit2(const expression::Binary &expr) -> eval_result_t {
       "unimplemented binary operator.\n[line {}]", expr.op.line)};
 }
 auto interpreter::visit2(const expression::Grouping &expr) -> eval_result_t {
-  return {expr.expr->accept(*this)};
+  return {evaluate(*expr.expr)};
 }
 auto interpreter::visit2(const expression::Variable &expr) -> eval_result_t {
-  return find_variable(expr.shared_from_this(), expr.name);
+  return find_variable(expr, expr.name);
 }
 auto interpreter::visit2(const expression::Assignment &expr) -> eval_result_t {
   auto res = this->evaluate(*expr.value_expr);
   if (!res)
     return res;
 
-  if (auto it = local_env.find(expr.shared_from_this());
-      it != local_env.end()) {
-    if (auto reassign_res = env->reassign_at_depth(
-            it->second, expr.name.to_string(kDetailed), *res, expr.name.line);
-        !reassign_res)
-      return reassign_res;
-
-  } else if (!Environment::Global()->reassign(
-                 expr.name.to_string(kDetailed), *res, expr.name.line)) {
+  if (auto it = local_env.find(expr); it != local_env.end()) {
+    auto value = lookup(it->second);
+    if (!value)
+      return {auxilia::NotFoundError("Undefined variable '{}'.\n[line {}]",
+                                     expr.name.to_string(kDetailed),
+                                     expr.name.line)};
+    *value = *res;
+  } else if (!globals->reassign(expr.name.symbol, *res, expr.name.line)) {
     return {auxilia::NotFoundError("Undefined variable '{}'.\n[line {}]",
                                    expr.name.to_string(kDetailed),
                                    expr.name.line)};
@@ -423,32 +482,50 @@ auto interpreter::visit2(const expression::Assignment &expr) -> eval_result_t {
   return *res;
 }
 auto interpreter::visit2(const expression::Logical &expr) -> eval_result_t {
-  auto lhs = expr.left->accept(*this);
+  auto lhs = evaluate(*expr.left);
   if (!lhs)
     return lhs;
   if (is_true_value(*lhs).is_true()) {
     if (expr.op.is_type(kOr))
       return {*lhs};
     if (expr.op.is_type(kAnd))
-      return {expr.right->accept(*this)};
+      return {evaluate(*expr.right)};
     contract_assert(false, "unimplemented logical operator")
     return {auxilia::Monostate{}};
   }
   // left is false, evaluate right.
   if (expr.op.is_type(kOr))
-    return {expr.right->accept(*this)};
+    return {evaluate(*expr.right)};
   if (expr.op.is_type(kAnd))
-    return {evaluation::Boolean{false, expr.op.line}};
+    return {evaluation::Boolean{false}};
   contract_assert(false, "unimplemented logical operator")
   return {auxilia::Monostate{}};
 }
 auto interpreter::visit2(const expression::Call &expr) -> eval_result_t {
-  auto res = evaluate(*expr.callee);
-  if (!res)
+  const auto top = stack.size();
+  defer { pop_args(top); };
+
+  eval_result_t res;
+  if (expr.property) {
+    // a method called right away is not bound: the instance goes straight
+    // into the receiver slot of its frame.
+    auto object = evaluate(*expr.property->object);
+    if (!object)
+      return object;
+    const auto entry = find_property(*expr.property, *object);
+    if (!entry)
+      return {entry.as_status()};
+    if (const auto method = (*entry)->method) {
+      auto args = push_args(expr, method->arity());
+      if (!args)
+        return {args.as_status()};
+      return method->call_method(*this, *object, *args);
+    }
+    res = {object->get<evaluation::Instance>().field_at((*entry)->slot)};
+  } else if (res = evaluate(*expr.callee); !res) {
     return res;
+  }
 
-  // `result` would change in `get_call_args`, so we need to save it.
-  const auto callee = expr.callee;
   evaluation::Callable *callable;
   // a bit less-readable, may change to a more readable version later.
   if (!((callable = res->get_if<evaluation::Function>())))
@@ -456,23 +533,12 @@ auto interpreter::visit2(const expression::Call &expr) -> eval_result_t {
       return {auxilia::InvalidArgumentError(
           "Can only call functions and classes.\n[line {}]", expr.paren.line)};
 
-  auto maybe_args = get_call_args(expr);
-  if (!maybe_args)
-    return {maybe_args.as_status()};
-
-  auto args = *std::move(maybe_args);
-  if (args.size() == callable->arity())
-    // clear `Returning` status has already been implemented in `call` method.
-    // just return here.
-    return callable->call(*this, std::move(args));
-
-  return {auxilia::InvalidArgumentError(
-      "Too {} arguments to call function '{}': "
-      "expected {} but got {}",
-      args.size() > callable->arity() ? "many" : "few",
-      callee->to_string(kDefault),
-      callable->arity(),
-      args.size())};
+  auto args = push_args(expr, callable->arity());
+  if (!args)
+    return {args.as_status()};
+  // clear `Returning` status has already been implemented in `call` method.
+  // just return here.
+  return callable->call(*this, *args);
 }
 
 auto interpreter::visit2(const expression::Get &expr) -> eval_result_t {
@@ -480,12 +546,13 @@ auto interpreter::visit2(const expression::Get &expr) -> eval_result_t {
   if (!res)
     return res;
 
-  if (!res->is_type<evaluation::Instance>()) {
-    return {auxilia::InvalidArgumentError(
-        "Only instances have fields.\n[line {}]", expr.field.line)};
-  }
-  return {res->get<evaluation::Instance>().get_field(
-      expr.field.to_string(kDetailed))};
+  const auto entry = find_property(expr, *res);
+  if (!entry)
+    return {entry.as_status()};
+  auto &instance = res->get<evaluation::Instance>();
+  if ((*entry)->method)
+    return {(*entry)->method->bind(instance)};
+  return {instance.field_at((*entry)->slot)};
 }
 auto interpreter::visit2(const expression::Set &expr) -> eval_result_t {
   auto res = evaluate(*expr.object);
@@ -501,23 +568,26 @@ auto interpreter::visit2(const expression::Set &expr) -> eval_result_t {
   if (!maybe_value)
     return maybe_value;
 
-  return {res->get<evaluation::Instance>().set_field(
-      expr.field.to_string(kDetailed), *std::move(maybe_value))};
+  // like js or python, we can set a field even if it is not defined yet.
+  auto &instance = res->get<evaluation::Instance>();
+  const auto entry = lookup_property(expr.cache, instance, expr.field, true);
+  if (entry->next)
+    instance.add_field(entry->next, *std::move(maybe_value));
+  else
+    instance.field_at(entry->slot) = *std::move(maybe_value);
+  return {};
 }
 auto interpreter::visit2(const expression::This &expr) -> eval_result_t {
-  return find_variable(expr.shared_from_this(), expr.name);
+  return find_variable(expr, expr.name);
 }
 auto interpreter::visit2(const expression::Super &expr) -> eval_result_t {
-  auto it = local_env.find(expr.shared_from_this());
+  auto it = local_env.find(expr);
 
   contract_assert(
       it != local_env.end(),
       "super class should be in local env; this shall be resolved in Resolver")
 
-  const auto depth = it->second;
-  
-  auto superclass_ptr =
-      env->get_at_depth(depth, "super")->get_if<evaluation::Class>();
+  auto superclass_ptr = lookup(it->second)->get_if<evaluation::Class>();
   if (!superclass_ptr) {
     dbg(info, "environment: {}", env->to_string(kDetailed))
     return {auxilia::NotFoundError("Superclass not found in the environment.")};
@@ -525,7 +595,7 @@ auto interpreter::visit2(const expression::Super &expr) -> eval_result_t {
   dbg(info, "superclass name: {}", superclass_ptr->to_string(kDetailed))
 
   auto object_ptr =
-      env->get_at_depth(depth - 1, "this")->get_if<evaluation::Instance>();
+      lookup(local_env.find(expr.method)->second)->get_if<evaluation::Instance>();
   if (!object_ptr) {
     dbg(info, "environment: {}", env->to_string(kDetailed))
     return {auxilia::NotFoundError(
@@ -535,7 +605,7 @@ auto interpreter::visit2(const expression::Super &expr) -> eval_result_t {
   
   // clang-format off
   return superclass_ptr
-      ->get_method(expr.method.to_string(kDetailed))
+      ->get_method(expr.method)
       .transform([&](auto &&method) -> variant_type {
         return {method.bind(*object_ptr)};
       });
@@ -545,7 +615,7 @@ auto interpreter::visit2(const expression::Super &expr) -> eval_result_t {
 #pragma region utility
 auto interpreter::expr_to_string(
     const auxilia::FormatPolicy &format_policy) const -> string_type {
-  return value_to_string(format_policy, last_expr_res);
+  return value_to_string(format_policy, expression_result);
 }
 auto interpreter::value_to_string(const auxilia::FormatPolicy &format_policy,
                                   const eval_result_t &value) const
@@ -554,11 +624,11 @@ auto interpreter::value_to_string(const auxilia::FormatPolicy &format_policy,
 }
 auto interpreter::to_string(const auxilia::FormatPolicy &format_policy) const
     -> string_type {
-  dbg(info, "last_expr_res index: {}", last_expr_res->index())
+  dbg(info, "expression_result index: {}", expression_result->index())
   dbg(info, "stmts size: {}", stmts_res.size())
   if (stmts_res.empty()) { // we are parse an expression, not a statement
-    if (last_expr_res->index() && !is_interpreting_stmts)
-      return value_to_string(format_policy, last_expr_res);
+    if (expression_result->index() && !is_interpreting_stmts)
+      return value_to_string(format_policy, expression_result);
     return {};
   }
 
@@ -581,46 +651,92 @@ auto interpreter::to_string(const auxilia::FormatPolicy &format_policy) const
 }
 evaluation::Boolean
 interpreter::is_true_value(const eval_result_t &value) const {
-  return value->visit(match(
-      [](const evaluation::Nil &n) {
-        return evaluation::Boolean::make_false(n.get_line());
-      },
-      [](const evaluation::Boolean &b) { return b; },
-      [](const auto &) { return evaluation::True; }));
+  return {value->is_truthy()};
 }
 auto interpreter::is_deep_equal(const eval_result_t &lhs,
                                 const eval_result_t &rhs) const
     -> evaluation::Boolean {
-  using Bool = evaluation::Boolean;
-  auto pattern = match(
-      [](const evaluation::Nil &l, const evaluation::Nil &r) -> Bool {
-        return {Bool::make_true(l.get_line())};
-      },
-      []<typename T>(const T &l, const T &r) -> Bool { return {l == r}; },
-      [](const auto &l, const auto &r) -> Bool {
-        return {Bool{evaluation::False}};
-      });
-  return auxilia::visit(pattern, *lhs, *rhs);
+  return {*lhs == *rhs};
 }
-auto interpreter::get_call_args(const expression::Call &expr) const
-    -> auxilia::StatusOr<std::vector<variant_type>> {
-  auto args = std::vector<variant_type>{};
-  args.reserve(expr.args.size());
+auto interpreter::push_args(const expression::Call &expr, const unsigned arity)
+    -> auxilia::StatusOr<evaluation::Callable::args_t> {
+  const auto first = stack.size() + 1;
+  stack.resize(first + expr.args.size());
+  stack_cells.resize(first + expr.args.size());
 
   // we choose to evaluate argument expressions from left to right, adhering
   // to "Sequenced before" rules in C++11 and later.
   // https://en.cppreference.com/w/cpp/language/eval_order
-  for (const auto &arg : expr.args) {
-    auto res = evaluate(*arg);
+  // the frames of calls among them go above the arguments, and the stack may
+  // grow meanwhile, so the slots are indexed afresh.
+  for (auto i = 0uz; i < expr.args.size(); ++i) {
+    auto res = evaluate(*expr.args[i]);
     if (!res)
       return {res.as_status()};
-    args.emplace_back(*res);
+    stack[first + i] = *std::move(res);
+  }
+  if (expr.args.size() != arity)
+    return auxilia::InvalidArgumentError(
+        "Too {} arguments to call function '{}': "
+        "expected {} but got {}",
+        expr.args.size() > arity ? "many" : "few",
+        expr.callee->to_string(kDefault),
+        arity,
+        expr.args.size());
+  return {evaluation::Callable::args_t{stack}.subspan(first)};
+}
+void interpreter::pop_args(const size_t top) {
+  stack.resize(top);
+  stack_cells.resize(top);
+}
+auto interpreter::lookup_property(expression::PropertyCache &cache,
+                                  const evaluation::Instance &instance,
+                                  const Token &name,
+                                  const bool is_set)
+    -> const expression::PropertyCache::entry_t * {
+  const auto shape = &instance.get_shape();
+  if (const auto entry = cache.find(shape)) {
+    ++cache_stats.hits;
+    return entry;
+  }
+  ++cache_stats.misses;
+  auto entry = expression::PropertyCache::entry_t{
+      .shape = shape,
+      .slot = shape->find(name.symbol),
+      .klass = variant_type::share(instance.get_class())};
+  if (entry.slot == evaluation::Shape::npos) {
+    if (is_set) {
+      entry.slot = shape->size();
+      entry.next = shape->with(name.symbol);
+    } else if (!((entry.method =
+                      instance.get_class().find_method(name.symbol)))) {
+      return nullptr;
+    }
   }
-  return {args};
+  return &cache.add(std::move(entry));
+}
+auto interpreter::find_property(const expression::Get &expr,
+                                const variant_type &object)
+    -> auxilia::StatusOr<const expression::PropertyCache::entry_t *> {
+  const auto instance = object.get_if<evaluation::Instance>();
+  if (!instance)
+    return auxilia::InvalidArgumentError(
+        "Only instances have fields.\n[line {}]", expr.field.line);
+  if (const auto entry =
+          lookup_property(expr.cache, *instance, expr.field, false))
+    return {entry};
+  return instance->get_field(expr.field).as_status();
 }
 auto interpreter::get_function(const statement::Function &stmtFunc,
                                const bool is_initializer)
     -> evaluation::Function {
+  const auto &frame = frames.at(&stmtFunc);
+  evaluation::Function::upvalues_t upvalues;
+  upvalues.reserve(frame.captures.size());
+  for (const auto &[depth, slot] : frame.captures)
+    upvalues.emplace_back(depth == location_t::upvalue_depth
+                              ? (*this->upvalues)[slot]
+                              : capture_slot(slot));
   // clang-format off
   return evaluation::Function::create_custom(
     stmtFunc.parameters.size(),
@@ -628,21 +744,26 @@ auto interpreter::get_function(const statement::Function &stmtFunc,
       .name = stmtFunc.name.to_string(kDetailed),
       .parameters = stmtFunc.parameters
                     | std::ranges::views::transform([&](const auto &param) {
-                        return param.to_string(kDetailed);
+                        return param.symbol;
                       })
-                    | std::ranges::to<std::vector<string_type>>(),
-      .body = stmtFunc.body.statements
+                    | std::ranges::to<std::vector<symbol_id_t>>(),
+      .body = stmtFunc.body.statements,
+      .frame_size = frame.size,
+      .captured_parameters = frame.captured_parameters
     },
-    this->env,
+    std::move(upvalues),
     is_initializer);
   // clang-format on
 }
-auto interpreter::find_variable(const cexpr_ptr_t &expr, const Token &name)
+auto interpreter::find_variable(const expression::Expr &expr,
+                                const Token &name)
     -> eval_result_t {
-  if (auto it = local_env.find(expr); it != local_env.end()) {
-    return *env->get_at_depth(it->second, name.to_string(kDetailed));
-  }
-  if (auto res = Environment::Global()->get(name.to_string(kDetailed));
+  if (auto it = local_env.find(expr); it != local_env.end())
+    if (auto res = lookup(it->second))
+      return *res;
+
+  // late-bound: never resolved, or not defined yet.
+  if (auto res = globals->get(name.symbol);
       res && !res->empty()) {
     return *res;
   }
@@ -651,6 +772,47 @@ auto interpreter::find_variable(const cexpr_ptr_t &expr, const Token &name)
                                  name.to_string(kDetailed),
                                  name.line)};
 }
+auto interpreter::define_variable(const statement::Stmt &stmt,
+                                  const Token &name,
+                                  const variant_type &value)
+    -> auxilia::Status {
+  if (auto it = local_env.find(stmt); it != local_env.end()) {
+    define_at(it->second, name.symbol, value);
+    return {};
+  }
+  return env->add(name.symbol, value, name.line);
+}
+/// @return the resolved variable, or nullptr if it's a global not defined yet.
+auto interpreter::lookup(const location_t &location) const -> variant_type * {
+  switch (location.depth) {
+  case location_t::global_depth:
+    return globals->find_at(location.slot);
+  case location_t::upvalue_depth:
+    return (*upvalues)[location.slot].get();
+  case location_t::cell_depth:
+    return stack_cells[frame_base + location.slot].get();
+  default:
+    return const_cast<variant_type *>(&stack[frame_base + location.slot]);
+  }
+}
+/// @brief a captured local gets a fresh cell each time its declaration runs,
+/// so closures made in different iterations of a loop don't share it.
+void interpreter::declare_variable(const statement::Stmt &stmt) {
+  if (auto it = local_env.find(stmt); it != local_env.end())
+    declare_at(it->second);
+}
+void interpreter::declare_at(const location_t &location) {
+  if (location.depth == location_t::cell_depth)
+    stack_cells[frame_base + location.slot] = std::make_shared<variant_type>();
+}
+void interpreter::define_at(const location_t &location,
+                            const symbol_id_t name,
+                            const variant_type &value) {
+  if (location.depth == location_t::global_depth)
+    globals->define_at(location.slot, name, value);
+  else
+    *lookup(location) = value;
+}
 AC_LOX_API void delete_interpreter_fwd(interpreter *ptr) { delete ptr; }
 #pragma endregion utility
 } // namespace accat::lox
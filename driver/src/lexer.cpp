@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <charconv>
 #include <concepts>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <source_location>
 #include <sstream>
 #include <string>
@@ -45,10 +47,11 @@ lexer::lexer(lexer &&other) noexcept
     : head(std::exchange(other.head, 0)),
       cursor(std::exchange(other.cursor, 0)),
       contents(std::move(const_cast<string_type &>(other.contents))),
-      lexeme_views(std::move(other.lexeme_views)),
-      current_line(std::exchange(other.current_line, 1)),
+      newlines(std::move(other.newlines)),
+      line_hint(std::exchange(other.line_hint, 0)),
       tokens(std::move(other.tokens)),
-      error_count(std::exchange(other.error_count, 0)) {}
+      error_count(std::exchange(other.error_count, 0)),
+      symbols(std::move(other.symbols)) {}
 lexer &lexer::operator=(lexer &&other) noexcept {
   if (this == &other)
     return *this;
@@ -56,10 +59,11 @@ lexer &lexer::operator=(lexer &&other) noexcept {
   cursor = std::exchange(other.cursor, 0);
   const_cast<string_type &>(contents) =
       std::move(const_cast<string_type &>(other.contents));
-  lexeme_views = std::move(other.lexeme_views);
-  current_line = std::exchange(other.current_line, 1);
+  newlines = std::move(other.newlines);
+  line_hint = std::exchange(other.line_hint, 0);
   tokens = std::move(other.tokens);
   error_count = std::exchange(other.error_count, 0);
+  symbols = std::move(other.symbols);
 
   return *this;
 }
@@ -74,6 +78,9 @@ lexer::status_t lexer::load(const path_type &filepath) const {
                                           filepath.string());
   auto buffer = std::ostringstream{};
   buffer << file.rdbuf();
+  if (buffer.view().size() > std::numeric_limits<uint32_t>::max())
+    return auxilia::InvalidArgumentError("File too large: " +
+                                         filepath.string());
   const_cast<string_type &>(contents) = buffer.str();
   return {};
 }
@@ -82,9 +89,12 @@ lexer::status_t lexer::load(const std::istream &ss) {
     return auxilia::AlreadyExistsError("Content already loaded");
   std::ostringstream oss;
   oss << ss.rdbuf();
+  if (oss.view().size() > std::numeric_limits<uint32_t>::max())
+    return auxilia::InvalidArgumentError("Content too large");
   const_cast<string_type &>(contents) = oss.str();
   tokens.clear();
-  lexeme_views.clear();
+  newlines.clear();
+  line_hint = 0;
   return {};
 }
 
@@ -96,29 +106,34 @@ lexer::status_t lexer::lex() {
   add_token(kEndOfFile);
   return {};
 }
+auto lexer::next() -> compact_token_t {
+  // whitespace and comments add no token: go on until one is added.
+  while (tokens.empty()) {
+    if (is_at_end()) {
+      add_token(kEndOfFile);
+      break;
+    }
+    head = cursor;
+    next_token();
+  }
+  const auto token = tokens.back();
+  tokens.pop_back();
+  return token;
+}
 void lexer::add_identifier_and_keyword() {
   auto value = lex_identifier();
   auto it = keywords.find(value);
   if (it == keywords.end()) {
     dbg(trace, "identifier: {}", value)
-    add_token(kIdentifier, value);
+    add_token(kIdentifier);
     return;
   }
-  switch (it->second.type) {
-  case kTrue:
-    add_token(kTrue, true);
-    break;
-  case kFalse:
-    add_token(kFalse, false);
-    break;
-  default:
-    dbg(trace, "keyword: {}", value)
-    add_token(it->second);
-  }
+  dbg(trace, "keyword: {}", value)
+  add_token(it->second);
 }
 void lexer::add_number() {
   if (auto value = lex_number(false); !value.empty()) {
-    add_token(kNumber, value);
+    add_token(kNumber);
     return;
   }
   dbg(error, "invalid number.")
@@ -133,7 +148,8 @@ void lexer::add_string() {
     return;
   }
   dbg(trace, "string value: {}", value)
-  add_token(kString, value);
+  add_token(kString);
+  tokens.back().symbol = symbols->intern(value);
 }
 void lexer::add_comment() {
   while (peek() != '\n' && !is_at_end())
@@ -179,7 +195,7 @@ void lexer::next_token() {
     if (whitespace_chars.find(c) != string_view_type::npos)
       return;
     if (newline_chars.find(c) != string_view_type::npos) {
-      current_line++;
+      newlines.emplace_back(static_cast<uint32_t>(cursor - 1));
       return;
     }
     if (c == '"') {
@@ -217,27 +233,84 @@ bool lexer::advance_if_is(const char_t expected) {
 bool lexer::is_at_end(const size_t offset) const {
   return cursor + offset >= contents.size();
 }
-void lexer::add_token(const token_type_t &type, literal_type literal) {
+void lexer::add_token(const token_type_t &type, const error_code_t error) {
   if (type == kEndOfFile) { // FIXME: lexeme bug at EOF(not critical)
-    tokens.emplace_back(type, ""sv, literal_type{}, current_line);
+    tokens.emplace_back(type, error, static_cast<uint32_t>(contents.size()));
     return;
   }
   auto lexeme = string_view_type(contents.data() + head, cursor - head);
   dbg(trace, "lexeme: {}", lexeme)
-  tokens.emplace_back(type, lexeme, std::move(literal), current_line);
-  lexeme_views.emplace_back(lexeme);
+  tokens.emplace_back(type,
+                      error,
+                      static_cast<uint32_t>(head),
+                      static_cast<uint32_t>(cursor - head));
+  if (type == kIdentifier || type == kThis || type == kSuper)
+    tokens.back().symbol = symbols->intern(lexeme);
+}
+auto lexer::materialize(const compact_token_t &compact) const -> token_t {
+  const auto lexeme =
+      string_view_type(contents.data() + compact.offset, compact.length);
+  auto literal = literal_type{};
+  switch (compact.type.type) {
+  case kIdentifier:
+    literal = lexeme;
+    break;
+  case kString:
+    literal = lexeme.substr(1, lexeme.size() - 2);
+    break;
+  case kNumber:
+    literal = to_number<double>(lexeme);
+    break;
+  case kTrue:
+    literal = true;
+    break;
+  case kFalse:
+    literal = false;
+    break;
+  case kLexError:
+    literal = error_t{compact.error};
+    break;
+  default:
+    break;
+  }
+  auto token = token_t{compact.type,
+                       lexeme,
+                       std::move(literal),
+                       line_of(compact.offset + compact.length)};
+  token.symbol = compact.symbol;
+  return token;
+}
+auto lexer::line_of(const size_type offset) const noexcept -> uint_least32_t {
+  // the line breaks before the offset; those inside a multiline string count,
+  // so a token is on the line it ends on.
+  // tokens are mostly asked for in order, so walk on from the last answer and
+  // only search when going back or far ahead.
+  auto i = line_hint;
+  if (i && newlines[i - 1] >= offset) {
+    i = std::ranges::lower_bound(newlines, offset) - newlines.begin();
+  } else {
+    for (auto steps = 0; i < newlines.size() && newlines[i] < offset; ++i) {
+      if (++steps == 8) {
+        i = std::lower_bound(newlines.begin() + i, newlines.end(), offset) -
+            newlines.begin();
+        break;
+      }
+    }
+  }
+  line_hint = i;
+  return static_cast<uint_least32_t>(i + 1);
 }
 void lexer::add_lex_error(const error_code_t type) {
   dbg(error, "Lexical error: {}", contents.substr(head, cursor - head))
   error_count++;
-  return add_token(kLexError, literal_type{error_t{type}});
+  return add_token(kLexError, type);
 }
 lexer::status_t::Code lexer::lex_string() {
   while (peek() != '"' && !is_at_end()) {
+    // multiline string, of course we dont want act like C/C++ which will
+    // result in a compile error if the string is not closed at the same line.
     if (peek() == '\n')
-      current_line++; // multiline string, of course we dont want act like C/C++
-                      // which will result in a compile error if the string is
-                      // not closed at the same current_line.
+      newlines.emplace_back(static_cast<uint32_t>(cursor));
     get();
   }
   if (is_at_end() && peek() != '"') {
@@ -270,7 +343,7 @@ auto lexer::lex_number(const bool is_negative) -> literal_type {
   auto value = contents.substr(head, cursor - head);
   /// @note codecrafter's test view all of it as double
   (void)is_floating_point;
-  return to_number<long double>(value);
+  return to_number<double>(value);
   // if (is_negative && !is_floating_point) {
   //   return to_number<long long int>(value);
   // }
@@ -9,19 +9,45 @@
 #include "Token.hpp"
 #include "details/lox_fwd.hpp"
 
+#include "lexer.hpp"
 #include "statement.hpp"
 #include "expression.hpp"
 
 #include "parser.hpp"
 namespace accat::lox {
 // NOLINTBEGIN(misc-no-recursion)
-parser &parser::set_views(const token_views_t tokens) {
+parser &parser::set_views(const lexer &source) {
+  const auto tokens = token_views_t{source.get_tokens()};
   contract_assert(tokens.size() && tokens.back().is_type(kEndOfFile),
                   "tokens must have at least 1 token and ends with EOF")
+  this->source = &source;
   this->tokens = tokens;
   this->cursor = tokens.begin();
   return *this;
 }
+parser &parser::set_stream(lexer &source) {
+  this->source = &source;
+  this->stream = &source;
+  window.reserve(kWindowSize);
+  window.emplace_back(source.next());
+  tokens = window;
+  cursor = tokens.begin();
+  pull();
+  return *this;
+}
+void parser::pull() {
+  if (!stream || std::ranges::distance(cursor, tokens.end()) > 1 ||
+      tokens.back().is_type(kEndOfFile))
+    return;
+  const auto kept = cursor == tokens.begin() ? 0 : 1;
+  window.erase(window.begin(),
+               window.begin() + (std::ranges::distance(tokens.begin(), cursor) -
+                                 kept));
+  while (window.size() < kWindowSize && !window.back().is_type(kEndOfFile))
+    window.emplace_back(stream->next());
+  tokens = window;
+  cursor = tokens.begin() + kept;
+}
 bool parser::is_at_end(const size_type offset) const {
   // return cursor + offset >= tokens.end();
   /// @note: ^^^^^^ MSVC has iterator assertion on whether the iterator is past
@@ -33,8 +59,9 @@ bool parser::is_at_end(const size_type offset) const {
 }
 auto parser::get(const size_type offset) -> token_t {
   contract_assert(cursor < tokens.end(), "cursor out of range")
-  auto &token = *cursor;
+  auto token = source->materialize(*cursor);
   cursor += offset;
+  pull();
   return token;
 }
 auto parser::parse(const ParsePolicy &parse_policy) -> auxilia::Status try {
@@ -52,6 +79,18 @@ auto parser::parse(const ParsePolicy &parse_policy) -> auxilia::Status try {
   return status;
 }
 
+auto parser::parse_next() -> auxilia::StatusOr<stmt_ptr_t> try {
+  contract_assert(stream, "parse_next() needs set_stream()")
+  if (!keeps_statement)
+    arena.rewind(statement_mark);
+  statement_mark = arena.mark();
+  keeps_statement = false;
+  if (is_at_end())
+    return {nullptr};
+  return {next_declaration()};
+} catch (const auxilia::Status &status) {
+  return status;
+}
 auto parser::get_statements() const -> stmt_ptrs_t & {
   contract_assert(not stmts.empty(),
 
@@ -72,14 +111,16 @@ auto parser::assignment() -> expr_ptr_t {
   if (inspect(kEqual)) {
     auto eq_op = this->get();
     auto res = assignment();
-    if (auto variable = std::dynamic_pointer_cast<expression::Variable>(expr)) {
-      return std::make_shared<expression::Assignment>(std::move(variable->name),
-                                                      std::move(res));
+    if (expr->kind == expression::Expr::Kind::kVariable) {
+      auto variable = static_cast<expression::Variable *>(expr);
+      return arena.make<expression::Assignment>(std::move(variable->name),
+                                                std::move(res));
     }
-    if (auto get_expr = std::dynamic_pointer_cast<expression::Get>(expr)) {
-      return std::make_shared<expression::Set>(std::move(get_expr->object),
-                                               std::move(get_expr->field),
-                                               std::move(res));
+    if (expr->kind == expression::Expr::Kind::kGet) {
+      auto get_expr = static_cast<expression::Get *>(expr);
+      return arena.make<expression::Set>(std::move(get_expr->object),
+                                         std::move(get_expr->field),
+                                         std::move(res));
     }
     throw synchronize({parse_error::kUnknownError, "Expect variable name."});
   }
@@ -91,7 +132,7 @@ auto parser::logical_or() -> expr_ptr_t {
     auto or_op = this->get();
     auto rhs = logical_or();
     // FIXME: move myself and reassign it??? is it legal?
-    expr = std::make_shared<expression::Logical>(
+    expr = arena.make<expression::Logical>(
         std::move(or_op), std::move(expr), std::move(rhs));
   }
   return expr;
@@ -101,7 +142,7 @@ auto parser::logical_and() -> expr_ptr_t {
   while (inspect(kAnd)) {
     auto eq_op = this->get();
     auto rhs = equality();
-    expr = std::make_shared<expression::Logical>(
+    expr = arena.make<expression::Logical>(
         std::move(eq_op), std::move(expr), std::move(rhs));
   }
   return expr;
@@ -111,7 +152,7 @@ auto parser::equality() -> expr_ptr_t {
   while (inspect(kEqualEqual, kBangEqual)) {
     auto op = this->get();
     auto rhs = comparison();
-    equalityExpr = std::make_shared<expression::Binary>(
+    equalityExpr = arena.make<expression::Binary>(
         std::move(op), std::move(equalityExpr), std::move(rhs));
   }
   return equalityExpr;
@@ -121,7 +162,7 @@ auto parser::comparison() -> expr_ptr_t {
   while (inspect(kGreater, kGreaterEqual, kLess, kLessEqual)) {
     auto op = this->get();
     auto rhs = term();
-    comparisonExpr = std::make_shared<expression::Binary>(
+    comparisonExpr = arena.make<expression::Binary>(
         std::move(op), std::move(comparisonExpr), std::move(rhs));
   }
   return comparisonExpr;
@@ -131,7 +172,7 @@ auto parser::term() -> expr_ptr_t {
   while (inspect(kMinus, kPlus)) {
     auto op = this->get();
     auto rhs = factor();
-    termExpr = std::make_shared<expression::Binary>(
+    termExpr = arena.make<expression::Binary>(
         std::move(op), std::move(termExpr), std::move(rhs));
   }
   return termExpr;
@@ -141,7 +182,7 @@ auto parser::factor() -> expr_ptr_t {
   while (inspect(kSlash, kStar)) {
     auto op = this->get();
     auto rhs = unary();
-    factorExpr = std::make_shared<expression::Binary>(
+    factorExpr = arena.make<expression::Binary>(
         std::move(op), std::move(factorExpr), std::move(rhs));
   }
   return factorExpr;
@@ -150,7 +191,7 @@ auto parser::unary() -> expr_ptr_t {
   if (inspect(kBang, kMinus)) {
     auto op = this->get();
     auto rhs = unary();
-    return std::make_shared<expression::Unary>(std::move(op), std::move(rhs));
+    return arena.make<expression::Unary>(std::move(op), std::move(rhs));
   }
   return call();
 }
@@ -161,7 +202,7 @@ auto parser::call() -> expr_ptr_t {
     if (inspect(kLeftParen)) {
       auto paren = this->get();
       auto args = get_args();
-      expr = std::make_shared<expression::Call>(
+      expr = arena.make<expression::Call>(
           std::move(expr), std::move(paren), std::move(args));
     } else if (inspect(kDot)) {
       this->get();
@@ -171,7 +212,7 @@ auto parser::call() -> expr_ptr_t {
       }
       auto name = this->get();
       expr =
-          std::make_shared<expression::Get>(std::move(expr), std::move(name));
+          arena.make<expression::Get>(std::move(expr), std::move(name));
     } else
       break;
   }
@@ -180,17 +221,17 @@ auto parser::call() -> expr_ptr_t {
 }
 auto parser::primary() -> expr_ptr_t {
   if (inspect(kFalse))
-    return std::make_shared<expression::Literal>(this->get());
+    return arena.make<expression::Literal>(this->get());
   if (inspect(kTrue))
-    return std::make_shared<expression::Literal>(this->get());
+    return arena.make<expression::Literal>(this->get());
   if (inspect(kNil))
-    return std::make_shared<expression::Literal>(this->get());
+    return arena.make<expression::Literal>(this->get());
   if (inspect(kNumber))
-    return std::make_shared<expression::Literal>(this->get());
+    return arena.make<expression::Literal>(this->get());
   if (inspect(kString))
-    return std::make_shared<expression::Literal>(this->get());
+    return arena.make<expression::Literal>(this->get());
   if (inspect(kThis))
-    return std::make_shared<expression::This>(this->get());
+    return arena.make<expression::This>(this->get());
   if (inspect(kSuper)) {
     auto name = this->get();
     if (!inspect(kDot))
@@ -202,10 +243,10 @@ auto parser::primary() -> expr_ptr_t {
       throw synchronize(
           {parse_error::kUnknownError, "Expect property name after '.'."});
 
-    return std::make_shared<expression::Super>(std::move(name), this->get());
+    return arena.make<expression::Super>(std::move(name), this->get());
   }
   if (inspect(kIdentifier)) {
-    return std::make_shared<expression::Variable>(this->get());
+    return arena.make<expression::Variable>(this->get());
   }
   if (inspect(kLeftParen)) {
     this->get();
@@ -228,7 +269,7 @@ auto parser::primary() -> expr_ptr_t {
           {parse_error::kMissingParenthesis, "Expect expression."});
     }
     this->get();
-    return std::make_shared<expression::Grouping>(std::move(expr));
+    return arena.make<expression::Grouping>(std::move(expr));
   }
   // invalid evaluation reached
   throw synchronize({parse_error::kUnknownError, "Expect expression."});
@@ -309,10 +350,11 @@ auto parser::var_decl() -> stmt_ptr_t {
     throw synchronize({parse_error::kUnknownError, "Expect expression."});
   }
   this->get();
-  return std::make_shared<statement::Variable>(std::move(var_tok),
-                                               std::move(initializer));
+  return arena.make<statement::Variable>(std::move(var_tok),
+                                         std::move(initializer));
 }
 auto parser::function_decl_impl() -> statement::Function {
+  keeps_statement = true;
   auto name = this->get();
 
   if (!inspect(kLeftParen)) {
@@ -329,7 +371,7 @@ auto parser::function_decl_impl() -> statement::Function {
       std::move(name), std::move(parameters), std::move(body));
 }
 auto parser::function_decl() -> stmt_ptr_t {
-  return std::make_shared<statement::Function>(function_decl_impl());
+  return arena.make<statement::Function>(function_decl_impl());
 }
 auto parser::get_methods() -> std::vector<statement::Function> {
   std::vector<statement::Function> methods;
@@ -348,6 +390,7 @@ auto parser::get_methods() -> std::vector<statement::Function> {
   return methods;
 }
 auto parser::class_stmt() -> stmt_ptr_t {
+  keeps_statement = true;
   auto name = this->get();
 
   token_t superclass = token_t{};
@@ -365,10 +408,10 @@ auto parser::class_stmt() -> stmt_ptr_t {
         {parse_error::kMissingBrace, "Expect '{' before class body."});
   }
   this->get();
-  return std::make_shared<statement::Class>(
+  return arena.make<statement::Class>(
       std::move(name),
       superclass.is_type(kIdentifier)
-          ? std::make_shared<expression::Variable>(std::move(superclass))
+          ? arena.make<expression::Variable>(std::move(superclass))
           : nullptr,
       get_methods());
 }
@@ -392,17 +435,16 @@ auto parser::if_stmt() -> stmt_ptr_t {
     this->get();
     else_branch = next_statement();
   }
-  return std::make_shared<statement::If>(
+  return arena.make<statement::If>(
       std::move(condition), std::move(then_branch), std::move(else_branch));
 }
 auto parser::block_stmt() -> stmt_ptr_t {
-  return std::make_shared<statement::Block>(get_stmts());
+  return arena.make<statement::Block>(get_stmts());
 }
 auto parser::while_stmt() -> stmt_ptr_t {
   auto condition = get_condition();
   auto body = next_statement();
-  return std::make_shared<statement::While>(std::move(condition),
-                                            std::move(body));
+  return arena.make<statement::While>(std::move(condition), std::move(body));
 }
 auto parser::for_stmt() -> stmt_ptr_t {
   if (!inspect(kLeftParen)) {
@@ -426,7 +468,7 @@ auto parser::for_stmt() -> stmt_ptr_t {
   // else, no initializer
   // defaule condition is `true`.
   expr_ptr_t condition =
-      std::make_shared<expression::Literal>(Token(kTrue, "true"sv, {"true"sv}));
+      arena.make<expression::Literal>(Token(kTrue, "true"sv, {"true"sv}));
   if (!inspect(kSemicolon)) {
     condition = next_expression();
   }
@@ -443,14 +485,15 @@ auto parser::for_stmt() -> stmt_ptr_t {
   }
   this->get();
   auto body = next_statement();
-  return std::make_shared<statement::For>(std::move(initializer),
-                                          std::move(condition),
-                                          std::move(increment),
-                                          std::move(body));
+  return arena.make<statement::For>(std::move(initializer),
+                                    std::move(condition),
+                                    std::move(increment),
+                                    std::move(body));
 }
 auto parser::return_stmt() -> stmt_ptr_t {
   expr_ptr_t value = nullptr;
-  auto line = std::ranges::prev(cursor)->line;
+  const auto &keyword = *std::ranges::prev(cursor);
+  auto line = source->line_of(keyword.offset + keyword.length);
 
   if (!inspect(kSemicolon)) {
     value = next_expression();
@@ -459,7 +502,7 @@ auto parser::return_stmt() -> stmt_ptr_t {
     throw synchronize({parse_error::kUnknownError, "Expect ';'."});
   }
   this->get();
-  return std::make_shared<statement::Return>(std::move(value), line);
+  return arena.make<statement::Return>(std::move(value), line);
 }
 auto parser::print_stmt() -> stmt_ptr_t {
   auto value = next_expression();
@@ -467,7 +510,7 @@ auto parser::print_stmt() -> stmt_ptr_t {
     throw synchronize({parse_error::kUnknownError, "Expect expression."});
   }
   this->get();
-  return std::make_shared<statement::Print>(std::move(value));
+  return arena.make<statement::Print>(std::move(value));
 }
 auto parser::expr_stmt() -> stmt_ptr_t {
   auto expr = next_expression();
@@ -475,7 +518,7 @@ auto parser::expr_stmt() -> stmt_ptr_t {
     throw synchronize({parse_error::kUnknownError, "Expect expression."});
   }
   this->get();
-  return std::make_shared<statement::Expression>(std::move(expr));
+  return arena.make<statement::Expression>(std::move(expr));
 }
 auto parser::next_statement() -> stmt_ptr_t {
   if (inspect(kPrint)) {
@@ -520,7 +563,7 @@ auto parser::synchronize(const parse_error &parse_error) -> auxilia::Status {
   while (!is_at_end() && !inspect(kSemicolon)) {
     dbg_block
     {
-      auto discarded_token = peek();
+      auto discarded_token = source->materialize(peek());
       dbg(warn, "discarding {}", discarded_token);
     };
     this->get();
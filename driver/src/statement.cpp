@@ -14,9 +14,6 @@ namespace accat::lox::statement {
 using enum auxilia::FormatPolicy;
 using auxilia::FormatPolicy;
 
-Stmt::stmt_result_t Variable::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 auto Variable::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   return this->initializer->to_string(format_policy);
@@ -25,16 +22,10 @@ auto Print::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   return this->value->to_string(format_policy);
 }
-Stmt::stmt_result_t Print::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 auto Expression::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   return this->expr->to_string(format_policy);
 }
-Stmt::stmt_result_t Expression::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 auto Block::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   if (statements.empty())
@@ -48,21 +39,12 @@ auto Block::to_string(const FormatPolicy &format_policy) const
   result += "}\n";
   return result;
 }
-Stmt::stmt_result_t Block::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 
-Stmt::stmt_result_t If::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 auto While::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   return "while (" + this->condition->to_string(format_policy) + ") " +
          this->body->to_string(format_policy);
 }
-auto While::accept2(const StmtVisitor &visitor) const -> stmt_result_t {
-  return visitor.visit(*this);
-}
 auto If::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   string_type result = "if (" + this->condition->to_string(format_policy) +
@@ -85,22 +67,13 @@ auto Function::to_string(const FormatPolicy &format_policy) const
   result.append(") { ... }");
   return result;
 }
-auto Function::accept2(const StmtVisitor &visitor) const -> stmt_result_t {
-  return visitor.visit(*this);
-}
 auto Class::to_string(const auxilia::FormatPolicy &format_policy) const -> string_type {
   return "class "s.append(this->name.to_string(format_policy)).append(" { ... }");
 }
-auto Class::accept2(const StmtVisitor &visitor) const -> stmt_result_t {
-  return visitor.visit(*this);
-}
 auto Return::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   return "return "s.append(this->value->to_string(format_policy));
 }
-auto Return::accept2(const StmtVisitor &visitor) const -> stmt_result_t {
-  return visitor.visit(*this);
-}
 auto For::to_string(const FormatPolicy &format_policy) const
     -> string_type {
   auto result = "for ("s;
@@ -119,8 +92,5 @@ auto For::to_string(const FormatPolicy &format_policy) const
   result += ") " + this->body->to_string(format_policy);
   return result;
 }
-Stmt::stmt_result_t For::accept2(const StmtVisitor &visitor) const {
-  return visitor.visit(*this);
-}
 
 } // namespace accat::lox::statement
@@ -41,6 +41,13 @@ struct ExecutionContext {
   std::ostringstream output_stream{};
   std::ostringstream error_stream{};
   std::vector<std::filesystem::path> input_files;
+  /// @brief `--stats`: report how the interpreter's inline caches fared.
+  bool show_stats = false;
+  /// @brief `--stream`: run each top-level statement as soon as it is parsed,
+  /// rather than lex, parse and resolve the whole program first.
+  /// @note this drops the token vector and the nodes of finished statements,
+  /// not the source: memory is still O(source size).
+  bool streaming = false;
   std::unique_ptr<class lexer, decltype(&delete_lexer_fwd)> lexer;
   std::unique_ptr<class parser, decltype(&delete_parser_fwd)> parser;
   std::unique_ptr<class interpreter, decltype(&delete_interpreter_fwd)>
@@ -119,7 +126,12 @@ ExecutionContext::inspectArgs(const int argc, char **&argv, char **&envp) {
     dbg(error, "currently only one file is supported.")
   }
   for (auto i = 2ull; *(argv + i); ++i) {
-    ctx.input_files.emplace_back(*(argv + i));
+    if (std::string_view(*(argv + i)) == "--stats")
+      ctx.show_stats = true;
+    else if (std::string_view(*(argv + i)) == "--stream")
+      ctx.streaming = true;
+    else
+      ctx.input_files.emplace_back(*(argv + i));
   }
   return ctx;
 }
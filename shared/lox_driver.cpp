@@ -47,15 +47,16 @@ auxilia::Status onCommandNotFound(const ExecutionContext &ctx) {
       ExecutionContext::command_sv(ctx.commands.front()).data());
 }
 void writeLexResultsToContextStream(ExecutionContext &ctx,
-                                    const lexer::tokens_t &tokens) {
-  std::ranges::for_each(tokens, [&ctx](const auto &token) {
+                                    const lexer &lexer) {
+  const auto &tokens = lexer.get_tokens();
+  std::ranges::for_each(tokens, [&](const auto &token) {
     if (token.type == TokenType::kLexError) {
-      ctx.error_stream << token.to_string() << std::endl;
+      ctx.error_stream << lexer.materialize(token).to_string() << std::endl;
     }
   });
-  std::ranges::for_each(tokens, [&ctx](const auto &token) {
+  std::ranges::for_each(tokens, [&](const auto &token) {
     if (token.type != TokenType::kLexError) {
-      ctx.output_stream << token.to_string() << std::endl;
+      ctx.output_stream << lexer.materialize(token).to_string() << std::endl;
     }
   });
 }
@@ -81,7 +82,7 @@ auxilia::Status tokenize(ExecutionContext &ctx) {
 auxilia::Status parse(ExecutionContext &ctx) {
   dbg(info, "Parsing...")
   ctx.parser.reset(new parser);
-  ctx.parser->set_views(ctx.lexer->get_tokens());
+  ctx.parser->set_views(*ctx.lexer);
   auxilia::Status res;
   if (ctx.commands.front() == ExecutionContext::parse) {
     res = ctx.parser->parse(parser::kExpression);
@@ -97,14 +98,15 @@ auxilia::Status parse(ExecutionContext &ctx) {
 }
 auxilia::Status evaluate(ExecutionContext &ctx) {
   dbg(info, "evaluating...")
-  ctx.interpreter.reset(new interpreter);
-  auto res = ctx.interpreter->evaluate(*ctx.parser->get_expression());
+  ctx.interpreter.reset(new interpreter(ctx.lexer->get_symbols()));
+  auto res =
+      ctx.interpreter->evaluate_expression(*ctx.parser->get_expression());
   dbg(info, "evaluation completed.")
   return std::move(res).as_status();
 }
 auto interpret(ExecutionContext &ctx) {
   dbg(info, "interpreting...")
-  ctx.interpreter.reset(new interpreter);
+  ctx.interpreter.reset(new interpreter(ctx.lexer->get_symbols()));
 
   auto resolver = Resolver{*ctx.interpreter};
   if (auto res = resolver.resolve(ctx.parser->get_statements()); !res)
@@ -113,10 +115,69 @@ auto interpret(ExecutionContext &ctx) {
   Environment::isGlobalScopeInited = false;
   auto res = ctx.interpreter->interpret(ctx.parser->get_statements());
   dbg(info, "interpretation completed.")
+  if (ctx.show_stats) {
+    const auto &stats = ctx.interpreter->get_cache_stats();
+    std::println(stderr,
+                 "inline caches: {} hits, {} misses",
+                 stats.hits,
+                 stats.misses);
+  }
   if (!res)
     return std::make_pair(std::move(res).as_status(), 70);
   return std::make_pair(std::move(res).as_status(), 0);
 }
+/// @brief `run --stream`: the parser pulls tokens from the lexer as it goes
+/// and each top-level statement is resolved and run as soon as it is parsed,
+/// then freed unless it declared a function or a class; what it printed is
+/// written out at once.
+/// @note unlike a plain `run`, the statements before one that fails to parse or
+/// resolve have already run; the source stays loaded whole, so memory is still
+/// O(source size).
+auto interpret_streaming(ExecutionContext &ctx, const bool to_stdout) {
+  ctx.lexer.reset(new lexer);
+  if (auto load_result = ctx.lexer->load(ctx.input_files.front());
+      !load_result.ok())
+    return std::make_pair(onFileOperationFailed(load_result), 1);
+  ctx.parser.reset(new parser);
+  ctx.parser->set_stream(*ctx.lexer);
+  ctx.interpreter.reset(new interpreter(ctx.lexer->get_symbols()));
+  Environment::isGlobalScopeInited = false;
+  ctx.interpreter->stream();
+
+  // like `interpret`, report the caches even if a statement fails
+  defer {
+    if (ctx.show_stats) {
+      const auto &stats = ctx.interpreter->get_cache_stats();
+      std::println(stderr,
+                   "inline caches: {} hits, {} misses",
+                   stats.hits,
+                   stats.misses);
+    }
+  };
+  auto resolver = Resolver{*ctx.interpreter};
+  const auto flush = [&] {
+    if (to_stdout)
+      std::cout << ctx.interpreter->to_string();
+    else
+      ctx.output_stream << ctx.interpreter->to_string();
+    ctx.interpreter->clear_output();
+  };
+  for (;;) {
+    auto stmt = ctx.parser->parse_next();
+    if (!stmt)
+      return std::make_pair(std::move(stmt).as_status(), 65);
+    if (!*stmt)
+      break;
+    if (auto res = resolver.resolve({&*stmt, 1}); !res)
+      return std::make_pair(std::move(res).as_status(), 65);
+    auto res = ctx.interpreter->interpret_next(**stmt);
+    flush();
+    if (!res)
+      return std::make_pair(std::move(res).as_status(), 70);
+    ctx.interpreter->retire(ctx.parser->keeps_last());
+  }
+  return std::make_pair(auxilia::Status{}, 0);
+}
 void writeParseResultToContextStream(ExecutionContext &ctx) {
   expression::ASTPrinter astPrinter;
   auto res = astPrinter.evaluate(*ctx.parser->get_expression());
@@ -157,13 +218,24 @@ int main(_In_ const int argc,
     std::println(stderr, "File not found: {}", ctx.input_files.front().string());
     return 1;
   }
+  if (ctx.streaming && ctx.commands.front() == ExecutionContext::interpret) {
+    const auto [result, returnCode] = interpret_streaming(ctx, argv != nullptr);
+    if (result.ok()) {
+      if (argv)
+        std::cout << std::endl;
+      return 0;
+    }
+    ctx.error_stream << result.message() << std::endl;
+    if (argv)
+      std::cerr << ctx.error_stream.view(); // DONT add newline character
+    return returnCode;
+  }
   auxilia::Status lex_result;
   if (ctx.commands.front() & ExecutionContext::needs_lex) {
     lex_result = tokenize(ctx);
   }
   if (ctx.commands.front() == ExecutionContext::lex) {
-    auto tokens = ctx.lexer->get_tokens();
-    writeLexResultsToContextStream(ctx, tokens);
+    writeLexResultsToContextStream(ctx, *ctx.lexer);
     // codecrafter's test needs stdout and stderr
     std::cerr << ctx.error_stream.str();
     std::cout << ctx.output_stream.str() << std::endl;
@@ -326,3 +326,35 @@ TEST(class, super_error3) {
       "[line 2] Error at 'super': Can't use 'super' outside of a class.\n");
   EXPECT_EQ(callback, 65);
 }
+
+TEST(class, property_undefined) {
+  const auto path = LOX_ROOT_DIR R"(\examples\class\property.undefined.lox)";
+  auto [callback, str] = get_result(path);
+  EXPECT_EQ(str, "Undefined property 'x'.\n[line 4]\n");
+  EXPECT_EQ(callback, 70);
+}
+
+TEST(class, property_order) {
+  const auto path = LOX_ROOT_DIR R"(\examples\class\property.order.lox)";
+  auto [callback, str] = get_result(path);
+  EXPECT_EQ(str,
+            "3\n"
+            "30\n"
+            "102\n"
+            "10\n"
+            "shadowed\n"
+            "102\n");
+  EXPECT_EQ(callback, 0);
+}
+TEST(class, instance_shadow) {
+  const auto path = LOX_ROOT_DIR R"(\examples\class\instance.shadow.lox)";
+  auto [callback, str] = get_result(path);
+  EXPECT_EQ(str,
+            "Cat makes a sound\n"
+            "inner animal\n"
+            "Animal instance\n"
+            "Cat makes a sound\n"
+            "Cat makes a sound\n"
+            "Animal instance\n");
+  EXPECT_EQ(callback, 0);
+}
@@ -11,6 +11,16 @@ auto get_result(const auto &filepath) {
                                ec.output_stream.str() + ec.error_stream.str())
               : std::make_pair(exec, ec.output_stream.str());
 }
+auto get_streamed_result(const auto &filepath) {
+  ExecutionContext ec;
+  ec.commands.emplace_back(ExecutionContext::interpret);
+  ec.input_files.emplace_back(filepath);
+  ec.streaming = true;
+  auto exec = accat::lox::main(3, nullptr, ec);
+  return exec ? std::make_pair(exec,
+                               ec.output_stream.str() + ec.error_stream.str())
+              : std::make_pair(exec, ec.output_stream.str());
+}
 } // namespace
 
 TEST(interpret, print) {
@@ -164,3 +174,35 @@ TEST(interpret, scope4) {
   EXPECT_EQ(str, "[line 6] Error at '': Expect '}'.\n");
   EXPECT_EQ(callback, 65);
 }
+
+TEST(interpret, number) {
+  const auto path = LOX_ROOT_DIR R"(\examples\interp\number.lox)";
+  auto [callback, str] = get_result(path);
+  EXPECT_EQ(str, "2147483648\n3.5\n2\n-0\ntrue\n9007199254740992\n"
+                 "140737488355328\n-140737488355329\n");
+  EXPECT_EQ(callback, 0);
+}
+
+TEST(interpret, stream) {
+  const auto path = LOX_ROOT_DIR R"(\examples\interp\stream.lox)";
+  auto [callback, str] = get_streamed_result(path);
+  EXPECT_EQ(str, "4\nhello world\n7\n3\ntrue\nseven\nhello\n");
+  EXPECT_EQ(callback, 0);
+  EXPECT_EQ(get_result(path), get_streamed_result(path));
+}
+
+TEST(interpret, stream_error) {
+  const auto path = LOX_ROOT_DIR R"(\examples\interp\expr2.lox)";
+  EXPECT_EQ(get_result(path), get_streamed_result(path));
+}
+
+TEST(interpret, stream_resolve_error) {
+  // the statements before the one failing to resolve have run already.
+  const auto path = LOX_ROOT_DIR R"(\examples\scope\redefine.mixed.lox)";
+  auto [callback, str] = get_streamed_result(path);
+  EXPECT_EQ(str,
+            "1\nnil\n2\n"
+            "[line 12] Error at 'a': "
+            "Already a variable with this name in this scope.\n");
+  EXPECT_EQ(callback, 65);
+}